@@ -3,6 +3,7 @@
 #define G4HepEmConfig_h 1
 
 #include "globals.hh"
+#include "G4ThreeVector.hh"
 
 #include <vector>
 #include <string>
@@ -55,6 +56,75 @@ public:
   void     SetWDTEnergyLimit(G4double ekin) { fWDTEnergyLimit = ekin; }
   G4double GetWDTEnergyLimit() { return fWDTEnergyLimit; }
 
+  // Set/get the size of the voxels of the material maps built for the Woodcock
+  // tracking root volumes: the material at most of the tentative interaction
+  // points is then obtained from the map instead of locating the point (0 means
+  // no voxel maps, which is the default).
+  void     SetWDTVoxelSize(G4double val) { fWDTVoxelSize = val; }
+  G4double GetWDTVoxelSize() { return fWDTVoxelSize; }
+
+  // Activate/deactivate the Woodcock tracking profiling mode: photon step
+  // statistics are collected per root logical volume of all regions (above the
+  // Woodcock tracking energy limit) to rank the regions by the benefit of the
+  // Woodcock tracking (see `G4HepEmWoodcockProfiler`).
+  void     SetWDTProfiling(G4bool val) { fIsWDTProfiling = val; }
+  G4bool   GetWDTProfiling() { return fIsWDTProfiling; }
+
+  // Activate/deactivate aggregation of the steps (that would invoke the
+  // sensitive detector) in a given detector region: consecutive steps of a
+  // track within the same touchable are merged into a single step (with summed
+  // energy deposit, first pre- and last post-step points) before the SD `Hit`.
+  // NOTE: this must be done before the initialissation of the run, i.e. right
+  //       after the construction of the `G4HepEmTrackinManager` !!!
+  void SetHitAggregationRegion(const std::string& regionName, G4bool val=true);
+  std::vector<std::string>& GetHitAggregationRegionNames() {
+    return fHitAggregationRegionNames;
+  }
+
+  // Activate the built-in energy deposit scoring mesh filled directly by the
+  // tracking manager (see `G4HepEmScoringMesh`): either a Cartesian mesh given
+  // by its min/max corners or a cylindrical mesh around the global z-axis.
+  // NOTE: this must be done before the initialissation of the run, i.e. right
+  //       after the construction of the `G4HepEmTrackinManager` !!!
+  void SetCartesianScoringMesh(const G4ThreeVector& minXYZ, const G4ThreeVector& maxXYZ,
+                               G4int nx, G4int ny, G4int nz);
+  void SetCylindricalScoringMesh(G4double rMax, G4double zMin, G4double zMax,
+                                 G4int nr, G4int nphi, G4int nz);
+  // Type of the scoring mesh: -1 none (default), 0 Cartesian, 1 cylindrical
+  G4int           GetScoringMeshType() { return fScoringMeshType; }
+  const G4int*    GetScoringMeshNumBins() { return fScoringMeshNumBins; }
+  const G4double* GetScoringMeshMin() { return fScoringMeshMin; }
+  const G4double* GetScoringMeshMax() { return fScoringMeshMax; }
+
+  // Set the density below which the materials are considered to be transparent
+  // (e.g. vacuum, low pressure gas): e-/e+ are transported there without MSC
+  // (i.e. without the related step limit, safety and displacement computations)
+  // while the mean energy loss and the discrete interactions are still sampled.
+  // (default: 0 --> inactive)
+  void     SetTransparentDensityThreshold(G4double val) { fTransparentDensityThreshold = val; }
+  G4double GetTransparentDensityThreshold() { return fTransparentDensityThreshold; }
+
+  // Activate/deactivate the navigation shortcut in daughterless volumes: the
+  // distance to the boundary and the safety are computed directly by the solid
+  // of the volume and the navigator is used only when the step leaves the
+  // volume (the field propagator is always used when a field is present).
+  // (default: false --> inactive)
+  void   SetLeafVolumeShortcut(G4bool val) { fIsLeafVolumeShortcut = val; }
+  G4bool GetLeafVolumeShortcut() { return fIsLeafVolumeShortcut; }
+
+  // Activate the kernel input recording mode: the inputs of the e-/e+ and gamma
+  // `HowFar` and `Perform` kernel calls are written into `<name>.t<thread-ID>.bin`
+  // and the G4HepEm state into `<name>.state.json` for the offline replay of the
+  // kernels (see `G4HepEmKernelRecorder`). The direction is also recorded when
+  // `isWithDirection` is set. (default: empty name --> inactive)
+  // NOTE: this must be done before the initialissation of the run, i.e. right
+  //       after the construction of the `G4HepEmTrackinManager` !!!
+  void SetKernelRecording(const std::string& fileBaseName, G4bool isWithDirection=false) {
+    fKernelRecordFileName    = fileBaseName;
+    fIsKernelRecordDirection = isWithDirection;
+  }
+  const std::string& GetKernelRecordFileName() { return fKernelRecordFileName; }
+  G4bool             GetKernelRecordDirection() { return fIsKernelRecordDirection; }
 
 
   // Set the `fDRoverRange` and `fFinalRange` parameters of the continuous energy
@@ -102,6 +172,50 @@ public:
   G4bool GetApplyCuts(const G4String& nameRegion);
   G4bool GetApplyCuts(int indxRegion);
 
+  // Set the e-/e+ tracking cut everywhere or in a given detector region: e-/e+
+  // are stopped when their energy drops below (default: G4 lowest e- energy)
+  void     SetElectronTrackingCut(G4double val, const G4String& nameRegion);
+  void     SetElectronTrackingCut(G4double val);
+  G4double GetElectronTrackingCut(const G4String& nameRegion);
+  G4double GetElectronTrackingCut(int indxRegion);
+
+  // Set the gamma kill threshold everywhere or in a given detector region: gamma
+  // tracks and secondaries below are killed, depositing their energy locally
+  // (default: 0 --> inactive)
+  void     SetGammaTrackingCut(G4double val, const G4String& nameRegion);
+  void     SetGammaTrackingCut(G4double val);
+  G4double GetGammaTrackingCut(const G4String& nameRegion);
+  G4double GetGammaTrackingCut(int indxRegion);
+
+  // Set the weight window everywhere or in a given detector region: e-/e+ and
+  // gamma entering the region with weight above `upper` are split while those
+  // below `lower` are rouletted, surviving with `survival` weight (the middle
+  // of the window or `lower` if `upper` is zero, i.e. no splitting, when not
+  // positive). Inactive unless set (default). A G4Exception is raised if `lower`
+  // is not positive, `upper` is neither zero nor above `lower` or `survival` is
+  // below `lower` (that would bias the weight).
+  void   SetWeightWindow(G4double lower, G4double upper, G4double survival, const G4String& nameRegion);
+  void   SetWeightWindow(G4double lower, G4double upper, G4double survival);
+  void   GetWeightWindow(const G4String& nameRegion, G4double& lower, G4double& upper, G4double& survival);
+  void   GetWeightWindow(int indxRegion, G4double& lower, G4double& upper, G4double& survival);
+
+  // Set the number of photons emitted per bremsstrahlung interaction (uniform
+  // brem splitting with 1/N weights) everywhere or in a given detector region
+  // (default: 1 --> no splitting)
+  void   SetBremSplitting(G4int num, const G4String& nameRegion);
+  void   SetBremSplitting(G4int num);
+  G4int  GetBremSplitting(const G4String& nameRegion);
+  G4int  GetBremSplitting(int indxRegion);
+
+  // Set leading particle biasing everywhere or in a given detector region: the
+  // most energetic product of brem, ionisation, Compton and conversion is kept
+  // while the others survive with probability proportional to their energy
+  // (default: false --> inactive)
+  void   SetLeadingParticleBiasing(G4bool val, const G4String& nameRegion);
+  void   SetLeadingParticleBiasing(G4bool val);
+  G4bool GetLeadingParticleBiasing(const G4String& nameRegion);
+  G4bool GetLeadingParticleBiasing(int indxRegion);
+
 
   // NOTE: to see if we set its memebr Parameters or it will have its own
   void SetG4HepEmParameters(G4HepEmParameters* hepEmPars) {
@@ -112,6 +226,9 @@ public:
 private:
   G4int GetRegionIndex(const G4String& nameRegion);
   void  CheckRegionIndex(G4int indxRegion);
+  // Validates the weight window and returns its survival weight (the default if
+  // `survival` is not positive).
+  G4double CheckWeightWindow(G4double lower, G4double upper, G4double survival);
 
 private:
 
@@ -124,6 +241,30 @@ private:
   std::vector<std::string> fWDTRegionNames;
   // Kinetic energy below which Woodcock tracking is turned off.*/
   G4double                 fWDTEnergyLimit;
+  // Voxel size of the Woodcock tracking material maps (0 means no voxel maps).
+  G4double                 fWDTVoxelSize;
+  // Flag to indicate if the Woodcock tracking profiling mode is active.
+  G4bool                   fIsWDTProfiling;
+
+  // The list of detector regions that the user requested hit aggregation in.
+  std::vector<std::string> fHitAggregationRegionNames;
+
+  // Type (-1 means no scoring mesh), number of bins and ranges of the scoring mesh.
+  G4int                    fScoringMeshType;
+  G4int                    fScoringMeshNumBins[3];
+  G4double                 fScoringMeshMin[3];
+  G4double                 fScoringMeshMax[3];
+
+  // Density below which the materials are transparent (0 means inactive).
+  G4double                 fTransparentDensityThreshold;
+
+  // Flag to indicate if the daughterless volume navigation shortcut is used.
+  G4bool                   fIsLeafVolumeShortcut;
+
+  // Base name of the kernel input record files (empty means inactive) and flag
+  // to indicate if the direction is also recorded.
+  std::string              fKernelRecordFileName;
+  G4bool                   fIsKernelRecordDirection;
 
 };
 
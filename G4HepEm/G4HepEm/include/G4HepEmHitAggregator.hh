@@ -0,0 +1,53 @@
+#ifndef G4HepEmHitAggregator_h
+#define G4HepEmHitAggregator_h 1
+
+#include "globals.hh"
+
+class G4Step;
+class G4VSensitiveDetector;
+
+/**
+ * @file    G4HepEmHitAggregator.hh
+ * @class   G4HepEmHitAggregator
+ * @date    2026
+ *
+ * Aggregates the consecutive steps of a track before invoking the sensitive
+ * detector (used by the `G4HepEmTrackingManager` in the hit aggregation regions,
+ * see `G4HepEmConfig::SetHitAggregationRegion`).
+ *
+ * A step is merged into the pending aggregated step (summed energy deposits and
+ * step length, first pre-step and last post-step points) if it's the
+ * continuation of that: same SD, same track, it starts in the touchable where
+ * the pending one ended and with the same (pre-step) weight. Otherwise, the
+ * pending aggregated step is handed over to its SD first. The aggregated step is
+ * also handed over when the track leaves the touchable (post-step point on a
+ * geometry boundary) or when the track is not alive anymore after the step.
+ */
+
+class G4HepEmHitAggregator {
+public:
+  G4HepEmHitAggregator();
+ ~G4HepEmHitAggregator();
+
+  G4HepEmHitAggregator(const G4HepEmHitAggregator&) = delete;
+  G4HepEmHitAggregator& operator=(const G4HepEmHitAggregator&) = delete;
+
+  // Invokes the sensitive detector with the given step: either directly or,
+  // when `isAggregate` is true, merging the step into the pending aggregated
+  // step (see above). The order of the hits is kept in both cases.
+  void Invoke(G4VSensitiveDetector* sensitive, G4Step& step, G4bool isAggregate);
+
+  // Invokes the sensitive detector with the pending aggregated step (if any).
+  void Flush();
+
+  // True if there is a pending aggregated step.
+  G4bool IsPending() const { return fSD != nullptr; }
+
+private:
+  // The step used to accumulate the consecutive steps and the SD of the pending
+  // aggregated step (nullptr if there is nothing pending).
+  G4Step*               fStep;
+  G4VSensitiveDetector* fSD;
+};
+
+#endif // G4HepEmHitAggregator_h
@@ -0,0 +1,84 @@
+
+#ifndef G4HepEmKernelRecorder_h
+#define G4HepEmKernelRecorder_h 1
+
+#include "G4HepEmKernelRecord.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct G4HepEmData;
+struct G4HepEmParameters;
+
+/**
+ * @file    G4HepEmKernelRecorder.hh
+ * @class   G4HepEmKernelRecorder
+ * @date    2026
+ *
+ * Records the inputs of the `HowFar` and `Perform` kernel calls done in the
+ * `G4HepEmTrackingManager` (i.e. particle, kinetic energy, HepEm material-cuts
+ * and region indices, winner process and optionally the direction) into a
+ * compact binary stream (see `G4HepEmKernelRecord`).
+ *
+ * The recording mode is activated by `G4HepEmConfig::SetKernelRecording`: each
+ * worker thread writes its own stream into the `<name>.t<thread-ID>.bin` file
+ * while the master writes the G4HepEm state (data and parameters) into the
+ * `<name>.state.json` file. These can then be replayed offline, through the
+ * `G4HepEmRun` kernels without Geant4, by the `ReplayKernels` benchmark tool.
+ *
+ * The records are buffered and written in blocks (and at the destruction).
+ */
+
+class G4HepEmKernelRecorder {
+public:
+  G4HepEmKernelRecorder(const std::string& fileName, bool isWithDirection, std::size_t bufferSize=65536);
+ ~G4HepEmKernelRecorder();
+
+  // Records the input of a kernel call.
+  void Record(std::uint8_t kernel, int particle, int process, double ekin, int hepEmIMC,
+              int region, double safety, bool onBoundary, const double* dir) {
+    G4HepEmKernelRecord rec;
+    rec.fEKin     = ekin;
+    rec.fSafety   = (float)safety;
+    rec.fHepEmIMC = hepEmIMC;
+    rec.fRegion   = (std::int16_t)region;
+    rec.fParticle = (std::uint8_t)particle;
+    rec.fKernel   = kernel;
+    rec.fProcess  = (std::int8_t)process;
+    rec.fFlags    = onBoundary ? G4HepEmKernelRecord::kOnBoundary : 0;
+    rec.fReserved = 0;
+    Append(&rec, sizeof(rec));
+    if (fIsWithDirection) {
+      const float fdir[3] = {(float)dir[0], (float)dir[1], (float)dir[2]};
+      Append(fdir, sizeof(fdir));
+    }
+  }
+
+  // Writes the buffered records into the file.
+  void Flush();
+
+  // Writes the G4HepEm state (data and parameters) in JSON format.
+  static bool WriteState(const std::string& fileName, G4HepEmData* hepEmData, G4HepEmParameters* hepEmPars);
+
+private:
+  void Append(const void* data, std::size_t size) {
+    if (fBufferPos + size > fBuffer.size()) {
+      Flush();
+    }
+    const char* bytes = static_cast<const char*>(data);
+    std::copy(bytes, bytes + size, fBuffer.begin() + fBufferPos);
+    fBufferPos += size;
+  }
+
+private:
+  bool              fIsWithDirection;
+  std::ofstream     fOutFile;
+  std::vector<char> fBuffer;
+  std::size_t       fBufferPos;
+};
+
+#endif // G4HepEmKernelRecorder_h
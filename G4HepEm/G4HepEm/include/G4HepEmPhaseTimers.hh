@@ -0,0 +1,94 @@
+
+#ifndef G4HepEmPhaseTimers_h
+#define G4HepEmPhaseTimers_h 1
+
+#include "G4HepEmSharedAccumulator.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct G4HepEmData;
+
+/**
+ * @file    G4HepEmPhaseTimers.hh
+ * @class   G4HepEmPhaseTimers
+ * @date    2026
+ *
+ * Low overhead, sampling based timing of the tracking phases done in the
+ * `G4HepEmTrackingManager` when G4HepEm is built with the `G4HepEm_PHASE_TIMERS`
+ * CMake option (i.e. no overhead otherwise).
+ *
+ * Only every `samplingPeriod`-th step of a thread is timed (by using the steady,
+ * i.e. `clock_gettime(CLOCK_MONOTONIC)`, clock) and the time of each phase is
+ * attributed to the HepEm material-cuts couple (so the region) of the step. The
+ * phases are: navigation (`MakeStep`, `FinishStep` and the relocation after the
+ * MSC displacement), safety computation (including that of the MSC displacement),
+ * HepEm physics step limits (`HowFar*`), continuous (energy loss, MSC) and
+ * discrete (`Perform*`) physics, user actions/SD and stacking of secondaries.
+ *
+ * The thread local times are merged into those of the master at the end of each
+ * event (see `G4HepEmSharedAccumulator`). The table of the estimated times (i.e.
+ * the sampled times scaled by the sampling period) per couple and phase can then
+ * be printed by the master (that can be obtained by `GetMasterPhaseTimers`) in
+ * the master `EndOfRunAction`.
+ */
+
+class G4HepEmPhaseTimers : public G4HepEmSharedAccumulator<G4HepEmPhaseTimers, std::uint64_t> {
+public:
+  enum Phase { kNavigation = 0, kSafety, kHowFar, kContinuous, kDiscrete,
+               kUserActions, kStacking, kNumPhases };
+
+  // The master owns the shared accumulator while the workers (`isMaster=false`)
+  // will merge their local times into that of the master.
+  G4HepEmPhaseTimers(bool isMaster, const struct G4HepEmData* hepEmData, int samplingPeriod=16);
+
+  static G4HepEmPhaseTimers* GetMasterPhaseTimers() { return GetMaster(); }
+
+  // Needs to be called at the beginning of each step: decides if the phases of
+  // this step are timed.
+  void StartStep() {
+    fIsSampled = (++fStepCounter == fSamplingPeriod);
+    if (fIsSampled) {
+      fStepCounter = 0;
+    }
+  }
+
+  // Starts timing a phase (only in sampled steps).
+  void Start() {
+    if (fIsSampled) {
+      fStartTime = Now();
+    }
+  }
+
+  // Stops timing the given phase and adds the time to the given couple.
+  void Stop(Phase phase, int hepEmIMC) {
+    if (fIsSampled) {
+      fLocalData[hepEmIMC*kNumPhases + phase] += Now() - fStartTime;
+    }
+  }
+
+  // Prints the table of the times per couple and phase (only by the master).
+  void Report(std::ostream& os = std::cout) const;
+
+private:
+  static std::uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+private:
+  bool                  fIsSampled;
+  int                   fSamplingPeriod;
+  int                   fStepCounter;
+  std::uint64_t         fStartTime;
+
+  // Region and material names of the HepEm material-cuts couples.
+  std::vector<std::string> fRegionNames;
+  std::vector<std::string> fMaterialNames;
+  // The local data are the times [ns] [#couples x kNumPhases].
+};
+
+#endif // G4HepEmPhaseTimers_h
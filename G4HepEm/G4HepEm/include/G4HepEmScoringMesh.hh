@@ -0,0 +1,87 @@
+
+#ifndef G4HepEmScoringMesh_h
+#define G4HepEmScoringMesh_h 1
+
+#include "G4HepEmSharedAccumulator.hh"
+
+#include <string>
+#include <vector>
+
+/**
+ * @file    G4HepEmScoringMesh.hh
+ * @class   G4HepEmScoringMesh
+ * @date    2026
+ *
+ * A lightweight, 3D energy deposit scoring mesh filled directly by the
+ * `G4HepEmTrackingManager` (i.e. without any SD or user stepping action).
+ *
+ * The mesh is either Cartesian, with bins in (x, y, z), or cylindrical around
+ * the global z-axis with bins in (r, phi, z) where phi is in [0, 2pi). The
+ * `[min, max]` ranges and number of bins are given per coordinate while
+ * deposits outside the mesh are ignored.
+ *
+ * The thread local mesh is merged into that of the master at the end of each
+ * event (see `G4HepEmSharedAccumulator`), only for the bins that were touched.
+ * The master mesh (that can be obtained by `GetMasterScoringMesh`) can then be
+ * written to a file in the master `EndOfRunAction` (and reset at the beginning
+ * of the next run if needed).
+ *
+ * The binary file format (native byte order) is:
+ *  - 8 characters `G4HEMESH`, followed by `int32` version (1) and mesh type
+ *    (0: Cartesian, 1: cylindrical);
+ *  - `int32` number of bins and `double` min and max values for the 3 coordinates;
+ *  - `double` energy deposit values [MeV] for all bins with the index of the
+ *    (i0, i1, i2) bin given as `(i0*n1 + i1)*n2 + i2`.
+ */
+
+class G4HepEmScoringMesh : public G4HepEmSharedAccumulator<G4HepEmScoringMesh, double> {
+public:
+  enum MeshType { kCartesian = 0, kCylindrical = 1 };
+
+  // The master mesh owns the shared accumulator while the workers (`isMaster=false`)
+  // will merge their local mesh into that of the master.
+  G4HepEmScoringMesh(bool isMaster, MeshType type, const int nbins[3],
+                     const double minVals[3], const double maxVals[3]);
+
+  static G4HepEmScoringMesh* GetMasterScoringMesh() { return GetMaster(); }
+
+  // Adds the energy deposit to the local bin that contains the given (global) point.
+  void Fill(double x, double y, double z, double edep) {
+    const int indx = GetBinIndex(x, y, z);
+    if (indx < 0) {
+      return;
+    }
+    if (fLocalData[indx] == 0.0) {
+      fTouchedBins.push_back(indx);
+    }
+    fLocalData[indx] += edep;
+  }
+
+  // Merges only the touched bins of the local mesh into the master one (see
+  // `G4HepEmSharedAccumulator::Merge`).
+  void Merge();
+
+  // Writes the shared accumulator (only by the master). Returns false on failure.
+  bool Write(const std::string& fileName) const;
+
+  MeshType GetType() const         { return fType; }
+  int      GetNumBins(int i) const { return fNumBins[i]; }
+  int      GetTotalNumBins() const { return fNumBins[0]*fNumBins[1]*fNumBins[2]; }
+  // Value of the shared accumulator at the given bin index.
+  double   GetValue(int indx) const { return GetSharedData(indx); }
+
+private:
+  int GetBinIndex(double x, double y, double z) const;
+
+private:
+  MeshType  fType;
+  int       fNumBins[3];
+  double    fMin[3];
+  double    fMax[3];
+  double    fInvDelta[3];
+
+  // The local data are the deposits per bin; the bins touched since the last merge.
+  std::vector<int>      fTouchedBins;
+};
+
+#endif // G4HepEmScoringMesh_h
@@ -0,0 +1,118 @@
+#ifndef G4HepEmSharedAccumulator_h
+#define G4HepEmSharedAccumulator_h 1
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/**
+ * @file    G4HepEmSharedAccumulator.hh
+ * @class   G4HepEmSharedAccumulator
+ * @date    2026
+ *
+ * Base of the run-level accumulators filled in the `G4HepEmTrackingManager`
+ * (e.g. `G4HepEmScoringMesh`, `G4HepEmStepCounters`, `G4HepEmPhaseTimers` and
+ * `G4HepEmWoodcockProfiler`) that owns their data and their master-worker merge.
+ *
+ * Each thread fills its own local data (the `fLocalData` array of the `Derived`
+ * class) while the master instance also owns the shared accumulator, i.e. an
+ * array of `std::atomic<T>` of the same size. The workers, that need to be
+ * constructed after the master (as in Geant4 MT), only point to the shared
+ * accumulator of the master. The local data are added to the shared accumulator
+ * at the end of each event (see `Merge`) by atomic compare-and-swap, i.e.
+ * lock-free without any thread local storage or mutex, then reset. The master
+ * instance (that can be obtained by `GetMaster`) can then report the shared
+ * accumulator in the master `EndOfRunAction`.
+ */
+
+template <typename Derived, typename T>
+class G4HepEmSharedAccumulator {
+public:
+  // The master instance (the one that owns the shared accumulator).
+  static Derived* GetMaster() { return gTheMaster; }
+
+  bool IsMaster() const { return fIsMaster; }
+
+  // Lock-free merge of the local data into the shared master accumulator and
+  // reset of the local ones.
+  void Merge() {
+    const int numData = fLocalData.size();
+    for (int i=0; i<numData; ++i) {
+      MergeData(i);
+    }
+  }
+
+  // Resets the shared accumulator (only by the master).
+  void Reset() {
+    if (!fIsMaster) {
+      return;
+    }
+    const int numData = fLocalData.size();
+    for (int i=0; i<numData; ++i) {
+      fSharedData[i].store(T(0), std::memory_order_relaxed);
+    }
+  }
+
+  // Value of the shared accumulator at the given index.
+  T GetSharedData(int indx) const { return fSharedData[indx].load(std::memory_order_relaxed); }
+
+protected:
+  G4HepEmSharedAccumulator(bool isMaster) : fIsMaster(isMaster), fSharedData(nullptr) {}
+
+ ~G4HepEmSharedAccumulator() {
+    if (fIsMaster && gTheMaster == static_cast<Derived*>(this)) {
+      gTheMaster = nullptr;
+    }
+  }
+
+  // Allocates the local data (and the shared accumulator in the master) or
+  // links the worker to the master accumulator that must have the same size
+  // (`name` is used only in the error message).
+  void InitSharedAccumulator(int numData, const char* name) {
+    fLocalData.assign(numData, T(0));
+    if (fIsMaster) {
+      fSharedDataOwned.reset(new std::atomic<T>[numData]);
+      fSharedData = fSharedDataOwned.get();
+      Reset();
+      gTheMaster = static_cast<Derived*>(this);
+    } else {
+      if (gTheMaster == nullptr || gTheMaster->fLocalData.size() != fLocalData.size()) {
+        std::cerr << " *** ERROR in " << name << ": the master has not been constructed"
+                  << " or doesn't match the worker! "
+                  << std::endl;
+        exit(-1);
+      }
+      fSharedData = gTheMaster->fSharedData;
+    }
+  }
+
+  // Merges (and resets) a single local data.
+  void MergeData(int indx) {
+    const T val = fLocalData[indx];
+    if (val != T(0)) {
+      T old = fSharedData[indx].load(std::memory_order_relaxed);
+      while (!fSharedData[indx].compare_exchange_weak(old, old+val, std::memory_order_relaxed)) {}
+      fLocalData[indx] = T(0);
+    }
+  }
+
+protected:
+  // Thread local data.
+  std::vector<T>  fLocalData;
+
+private:
+  bool            fIsMaster;
+
+  // The shared accumulator: owned by the master, the workers only point to it.
+  std::unique_ptr<std::atomic<T>[]> fSharedDataOwned;
+  std::atomic<T>*  fSharedData;
+
+  static Derived* gTheMaster;
+};
+
+template <typename Derived, typename T>
+Derived* G4HepEmSharedAccumulator<Derived, T>::gTheMaster = nullptr;
+
+#endif // G4HepEmSharedAccumulator_h
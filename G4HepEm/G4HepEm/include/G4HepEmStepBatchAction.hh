@@ -0,0 +1,43 @@
+
+#ifndef G4HepEmStepBatchAction_h
+#define G4HepEmStepBatchAction_h 1
+
+#include <cstddef>
+
+/**
+ * @file    G4HepEmStepBatchAction.hh
+ * @class   G4HepEmStepBatchAction
+ * @date    2026
+ *
+ * Optional, batched alternative of the user stepping action for the steps done
+ * in the `G4HepEmTrackingManager`.
+ *
+ * A small, POD `G4HepEmStepRecord` is stored for each step in a per-thread
+ * buffer of the tracking manager. The buffer is delivered to the user action
+ * (set by `G4HepEmTrackingManager::SetStepBatchAction`) when it's full, at the
+ * end of the event and, optionally, at the end of each track. Analysis codes
+ * that only histogram step quantities can then process the records in a tight
+ * loop, out of the hot tracking loop.
+ */
+
+struct G4HepEmStepRecord {
+  double fPosition[3];  // post-step point position
+  double fEDep;         // total energy deposit in the step
+  double fStepLength;   // (true) step length
+  double fWeight;       // weight of the track
+  int    fTrackID;      // ID of the track
+  int    fVolumeID;     // instance ID of the (pre-step point) logical volume
+  int    fParticleID;   // HepEm particle ID: 0 e-, 1 e+, 2 gamma
+};
+
+
+class G4HepEmStepBatchAction {
+public:
+  virtual ~G4HepEmStepBatchAction() {}
+
+  // Invoked with the `numSteps` step records accumulated since the last call.
+  // NOTE: the records are valid only during the call.
+  virtual void ProcessSteps(const G4HepEmStepRecord* records, std::size_t numSteps) = 0;
+};
+
+#endif // G4HepEmStepBatchAction_h
@@ -0,0 +1,104 @@
+
+#ifndef G4HepEmStepCounters_h
+#define G4HepEmStepCounters_h 1
+
+#include "G4HepEmSharedAccumulator.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file    G4HepEmStepCounters.hh
+ * @class   G4HepEmStepCounters
+ * @date    2026
+ *
+ * Per-region and per-particle (e-, e+ and gamma) step and interaction counters
+ * filled directly in the `G4HepEmTrackingManager` when G4HepEm is built with
+ * the `G4HepEm_STEP_COUNTERS` CMake option (i.e. no overhead otherwise).
+ *
+ * The following are counted for each region and particle:
+ *  - the number of steps and MSC sub-steps (e-/e+ only);
+ *  - the number of steps limited by the transportation (geometry), by the other
+ *    (e.g. user limits) and by the HepEm processes (including MSC) as well as
+ *    the number of interactions per process;
+ *  - the number of secondaries produced and killed by the cuts;
+ *  - the histogram of the step lengths with log10 bins between 1 [nm] and 10 [m].
+ *
+ * The thread local counters are merged into those of the master at the end of
+ * each event (see `G4HepEmSharedAccumulator`). The master counters (that can be
+ * obtained by `GetMasterStepCounters`) can then be written in JSON format in the
+ * master `EndOfRunAction`.
+ */
+
+class G4HepEmStepCounters : public G4HepEmSharedAccumulator<G4HepEmStepCounters, std::uint64_t> {
+public:
+  // The process slots: 0 transportation, 1 other (e.g. user limits), while
+  // `2+i` is the `i`-th HepEm process of the particle, i.e. e-/e+: eIoni, eBrem,
+  // annihl, msc, electronNuclear, positronNuclear and gamma: conv, compt, phot,
+  // photonNuclear.
+  static constexpr int kNumProcessSlots = 8;
+  // The step length histogram: log10 bins [mm] (under/overflow in the first/last bin).
+  static constexpr int    kNumHistBins        = 50;
+  static constexpr double kHistLog10Min       = -6.0;
+  static constexpr double kHistBinsPerDecade  = 5.0;
+
+  // The master owns the shared accumulator while the workers (`isMaster=false`)
+  // will merge their local counters into that of the master.
+  G4HepEmStepCounters(bool isMaster);
+
+  static G4HepEmStepCounters* GetMasterStepCounters() { return GetMaster(); }
+
+  // Counts a step of the given particle in the given region.
+  void CountStep(int indxRegion, int particleID, int limitSlot, bool isInteraction,
+                 double stepLength, int numMSCSubSteps) {
+    if (indxRegion >= fNumRegions) {
+      return;
+    }
+    std::uint64_t* data = &fLocalData[(indxRegion*3 + particleID)*kNumCounters];
+    data[kSteps]        += 1;
+    data[kMSCSubSteps]  += numMSCSubSteps;
+    data[kLimitedBy + limitSlot] += 1;
+    if (isInteraction) {
+      data[kInteractions + limitSlot] += 1;
+    }
+    int ib = 0;
+    if (stepLength > 0.0) {
+      ib = (int)std::floor((std::log10(stepLength) - kHistLog10Min)*kHistBinsPerDecade);
+      ib = ib < 0 ? 0 : (ib < kNumHistBins ? ib : kNumHistBins-1);
+    }
+    data[kHist + ib] += 1;
+  }
+
+  // Counts the secondaries produced by the given particle in the given region.
+  void CountSecondaries(int indxRegion, int particleID, int numProduced, int numKilled) {
+    if (indxRegion >= fNumRegions) {
+      return;
+    }
+    std::uint64_t* data = &fLocalData[(indxRegion*3 + particleID)*kNumCounters];
+    data[kSecProduced] += numProduced;
+    data[kSecKilled]   += numKilled;
+  }
+
+  // Writes the shared accumulator in JSON format (only by the master).
+  void WriteJSON(std::ostream& os) const;
+  // Same as above but into the given file. Returns false on failure.
+  bool WriteJSON(const std::string& fileName) const;
+
+private:
+  // The counters of a region and particle.
+  enum Counter { kSteps = 0, kMSCSubSteps, kSecProduced, kSecKilled,
+                 kLimitedBy, kInteractions = kLimitedBy + kNumProcessSlots,
+                 kHist = kInteractions + kNumProcessSlots,
+                 kNumCounters = kHist + kNumHistBins };
+
+private:
+  int                   fNumRegions;
+  std::vector<std::string> fRegionNames;
+
+  // The local data are the counters [#regions x 3 particles x kNumCounters].
+};
+
+#endif // G4HepEmStepCounters_h
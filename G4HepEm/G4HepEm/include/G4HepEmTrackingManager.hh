@@ -2,6 +2,7 @@
 #define G4HepEmTrackingManager_h 1
 
 #include "G4EventManager.hh"
+#include "G4HepEmStepBatchAction.hh"
 #include "G4VTrackingManager.hh"
 #include "globals.hh"
 
@@ -16,6 +17,17 @@ class G4VParticleChange;
 class G4Region;
 class G4HepEmWoodcockHelper;
 class G4HepEmConfig;
+class G4VSensitiveDetector;
+class G4HepEmScoringMesh;
+class G4HepEmWoodcockProfiler;
+class G4HepEmStepCounters;
+class G4HepEmPhaseTimers;
+class G4HepEmKernelRecorder;
+class G4HepEmHitAggregator;
+class G4LogicalVolume;
+class G4UserSteppingAction;
+class G4VTrajectory;
+struct G4HepEmRegionParmeters;
 
 #include <vector>
 
@@ -32,9 +44,47 @@ public:
 
   void HandOverOneTrack(G4Track *aTrack) override;
 
+  // Merges the thread local data (e.g. scoring mesh) at the end of each event
+  void FlushEvent() override;
+
   // Allows to set configuration/parameters (even some per region)
   G4HepEmConfig* GetConfig() { return fConfig; }
 
+  // The built-in scoring mesh of this thread (nullptr if not requested in the
+  // configuration). Use `G4HepEmScoringMesh::GetMasterScoringMesh()` to obtain
+  // the merged one in the master `EndOfRunAction`.
+  G4HepEmScoringMesh* GetScoringMesh() { return fScoringMesh; }
+
+  // The Woodcock tracking profiler of this thread (nullptr if not requested in
+  // the configuration). Use `G4HepEmWoodcockProfiler::GetMasterProfiler()` to
+  // obtain the merged one and print its `Report` in the master `EndOfRunAction`.
+  G4HepEmWoodcockProfiler* GetWoodcockProfiler() { return fWDTProfiler; }
+
+  // The kernel input recorder of this thread (nullptr if the recording was not
+  // requested in the configuration or on the master of an MT application).
+  G4HepEmKernelRecorder* GetKernelRecorder() { return fKernelRecorder; }
+
+#ifdef G4HepEm_STEP_COUNTERS
+  // The step counters of this thread (only with the `G4HepEm_STEP_COUNTERS`
+  // build option). Use `G4HepEmStepCounters::GetMasterStepCounters()` to obtain
+  // the merged ones and write them (`WriteJSON`) in the master `EndOfRunAction`.
+  G4HepEmStepCounters* GetStepCounters() { return fStepCounters; }
+#endif
+
+#ifdef G4HepEm_PHASE_TIMERS
+  // The tracking phase timers of this thread (only with the `G4HepEm_PHASE_TIMERS`
+  // build option). Use `G4HepEmPhaseTimers::GetMasterPhaseTimers()` to obtain
+  // the merged ones and print their `Report` in the master `EndOfRunAction`.
+  G4HepEmPhaseTimers* GetPhaseTimers() { return fPhaseTimers; }
+#endif
+
+  // Sets a batched (user) stepping action: the step records are delivered to
+  // the action in batches of `batchSize` (and at the end of each event and
+  // optionally at the end of each track). `nullptr` deactivates. The action is
+  // not owned (thread local, i.e. must be set for each worker).
+  void SetStepBatchAction(G4HepEmStepBatchAction* action, std::size_t batchSize=1024,
+                          G4bool isFlushAtEndOfTrack=false);
+
   // Control verbosity (0/1) (propagated to the G4HepEmRuManager)
   void SetVerbose(G4int verbose);
 
@@ -52,9 +102,15 @@ protected:
   // [0] e-; [1] e+; [2] gamma; nullptr: no fast sim manager process attached
   G4VProcess *fFastSimProcess[3];
 
+  // Pointers to the `G4StepLimiter` and `G4UserSpecialCuts` processes of the 3
+  // particles if any (indexed as above; nullptr: the process is not attached)
+  G4VProcess *fStepLimiterProcess[3];
+  G4VProcess *fUserSpecialCutsProcess[3];
+
 private:
   // Stacks secondaries created by HepEm physics (if any) and returns with the
   // energy deposit while stacking due to applying secondary production cuts
+  // and the regional e- and gamma tracking cuts
   double StackSecondaries(G4HepEmTLData* aTLData, G4Track* aG4PrimaryTrack,
                           const G4VProcess* aG4CreatorProcess, int aG4IMC,
                           bool isApplyCuts);
@@ -72,6 +128,37 @@ private:
   // stores in the local `fFastSimProcess` array (indexed by HepEm particle ID)
   void InitFastSimRelated(int particleID);
 
+  // Checks if the particle has the `G4StepLimiter` and/or `G4UserSpecialCuts`
+  // processes attached (stored by HepEm particle ID) and (re)builds the cache
+  // of the `G4UserLimits` of the logical volumes (indexed by their instance ID).
+  void InitUserLimitsRelated(int particleID);
+
+  // Computes the step limit due to the `G4UserLimits` of the current volume
+  // (given by its cache) exactly as `G4StepLimiter` and `G4UserSpecialCuts`
+  // would do (only those attached to the particle are considered). `range` is
+  // the current range of e-/e+ (`DBL_MAX` for gamma). The process limiting the
+  // step is written into `limitingProc` while `isKill` is set to true when the
+  // track needs to be stopped and killed right now (e.g. below min. energy).
+  G4double ComputeUserLimitsStep(int indxLogVol, const G4Track& track, int particleID,
+                                 G4double range, const G4VProcess** limitingProc,
+                                 G4bool& isKill) const;
+
+  // Stops and kills the track in a zero length step, depositing its kinetic
+  // energy, (as `G4UserSpecialCuts` does or when the gamma energy is below the
+  // regional gamma tracking cut) then invokes the end of step actions.
+  // (no energy is deposited when `isDeposit` is false, e.g. lost the roulette)
+  void KillTrackInZeroStep(G4Step& step, const G4VProcess* proc, G4LogicalVolume* lvol,
+                           G4UserSteppingAction* userSteppingAction,
+                           G4VTrajectory* trajectory, int particleID,
+                           G4bool isDeposit=true);
+
+  // Applies the weight window of the region to the track that is entering the
+  // region: either splits the track (the clones are added to the secondaries
+  // and they are not windowed again in this region) or plays Russian roulette.
+  // Returns false if the track lost the roulette.
+  G4bool ApplyWeightWindow(G4Track* aTrack, const G4HepEmRegionParmeters& regionPars,
+                           G4HepEmRandomEngine* rnge);
+
   // ATLAS XTR RELATED:
   // Called at init to find the ATLAS specific,Athena local transition radiation
   // process, detector region pointers and store them in field variables allowing
@@ -83,6 +170,39 @@ private:
   // Reports the extra physics configuration, i.e. nuclear and fast sim. processes
   void ReportExtraProcesses(int particleID);
 
+  // Sets the per region flags of hit aggregation based on the region names
+  // given in the configuration (see `G4HepEmConfig::SetHitAggregationRegion`)
+  void InitHitAggregation();
+
+  // Sets the transparent flags of the HepEm material-cuts couples based on the
+  // density threshold given in the configuration.
+  void InitTransparentMatCuts();
+
+  // Creates the scoring mesh if it was requested in the configuration.
+  void InitScoringMesh();
+
+  // Creates the Woodcock tracking profiler if it was requested in the
+  // configuration (HepEm data need to be available).
+  void InitWoodcockProfiler();
+
+  // Creates the kernel input recorder and writes the HepEm state if the kernel
+  // recording was requested in the configuration (see `G4HepEmKernelRecorder`).
+  void InitKernelRecorder();
+
+#ifdef G4HepEm_STEP_COUNTERS
+  // The step counter slot of the process that limited the step (see
+  // `G4HepEmStepCounters`) and the particle ID (0: e-, 1: e+, 2: gamma).
+  int GetStepCounterSlot(const G4VProcess* proc, int particleID) const;
+  int GetStepCounterParticleID(const G4Track* track) const;
+#endif
+
+  // Adds the record of the given step to the batch of the step batch action
+  // and delivers the batch if it's full.
+  void RecordStep(const G4Step& step, const G4LogicalVolume* lvol, int particleID);
+
+  // Delivers the step records accumulated so far (if any) to the batch action.
+  void FlushStepBatch();
+
 #ifdef G4HepEm_EARLY_TRACKING_EXIT
   // Virtual function to check early tracking exit. This function allows user
   // implementations to intercept the G4HepEm tracking loop based on
@@ -111,6 +231,9 @@ private:
   std::vector<G4HepEmNoProcess *> fElectronNoProcessVector;
   std::vector<G4HepEmNoProcess *> fGammaNoProcessVector;
   G4HepEmNoProcess *fTransportNoProcess;
+  // The process set as the creator of the clones of the weight window splitting
+  // and as the one limiting the step when killed by the weight window roulette.
+  G4HepEmNoProcess *fWeightWindowNoProcess;
 
   // Pointers to the Gamma-nuclear process (if any)
   G4VProcess* fGNucProcess;
@@ -131,6 +254,60 @@ private:
   // A vector of Woodcock tracking region names (set by user if any) and a helper.
   G4HepEmWoodcockHelper*   fWDTHelper;
 
+  // Hit aggregation: flags per region (indexed by the region instance ID) and
+  // the aggregator that invokes the sensitive detectors.
+  std::vector<G4bool>   fIsHitAggregationRegion;
+  G4bool                fIsHitAggregation;
+  G4HepEmHitAggregator* fHitAggregator;
+
+  // The `G4UserLimits` of the logical volumes cached at initialisation (indexed
+  // by the logical volume instance ID) and flags per particle indicating if
+  // any of the volumes has user limits that are active for the particle (i.e.
+  // the corresponding process is attached).
+  struct UserLimitsData {
+    G4double fMaxStep        = DBL_MAX;
+    G4double fMaxTrackLength = DBL_MAX;
+    G4double fMaxTime        = DBL_MAX;
+    G4double fMinEKin        = 0.0;
+    G4double fMinRange       = 0.0;
+    G4bool   fHasUserLimits  = false;
+  };
+  std::vector<UserLimitsData> fUserLimitsPerLogVol;
+  G4bool                      fIsUserLimits[3];
+
+  // Flags per HepEm material-cuts couple indicating if its material density is
+  // below the transparent threshold of the configuration (e-/e+ are transported
+  // without MSC in these couples).
+  std::vector<G4bool>   fIsTransparentMatCut;
+
+  // The built-in energy deposit scoring mesh (if any).
+  G4HepEmScoringMesh*   fScoringMesh;
+
+  // The Woodcock tracking profiler (if any).
+  G4HepEmWoodcockProfiler* fWDTProfiler;
+
+  // The kernel input recorder (if any) and flag to indicate if the HepEm state
+  // has already been written for the replay.
+  G4HepEmKernelRecorder* fKernelRecorder;
+  G4bool                 fIsKernelStateWritten;
+
+#ifdef G4HepEm_STEP_COUNTERS
+  // The per-region and per-particle step counters.
+  G4HepEmStepCounters*  fStepCounters;
+#endif
+
+#ifdef G4HepEm_PHASE_TIMERS
+  // The sampling based timers of the tracking phases.
+  G4HepEmPhaseTimers*   fPhaseTimers;
+#endif
+
+  // The batched stepping action (if any), the buffer of the step records, its
+  // size and the flag to deliver the batch at the end of each track.
+  G4HepEmStepBatchAction*        fStepBatchAction;
+  std::vector<G4HepEmStepRecord> fStepRecords;
+  std::size_t                    fStepBatchSize;
+  G4bool                         fIsFlushStepBatchAtEndOfTrack;
+
   // Configuration parameters (allows different parameters/configuration per region.
   G4HepEmConfig* fConfig;
 
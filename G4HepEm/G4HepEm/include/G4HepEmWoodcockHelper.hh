@@ -5,8 +5,7 @@
 #include "globals.hh"
 
 class G4VSolid;
-class G4MaterialCutsCouple;
-class G4Material;
+class G4Region;
 class G4LogicalVolume;
 class G4VPhysicalVolume;
 class G4Track;
@@ -14,8 +13,10 @@ class G4Track;
 class G4HepEmData;
 class G4HepEmMatCutData;
 class G4HepEmGammaTrack;
+class G4HepEmRandomEngine;
 
-#include <map>
+#include <memory>
+#include <vector>
 
 /**
  * @file    G4HepEmWoodcockHelper.hh
@@ -25,6 +26,13 @@ class G4HepEmGammaTrack;
  *
  * A helper class to perform Woodcock-tracking of photons in some Geant4 detector
  * regions (utilised in the G4HepEmTrackinManager).
+ *
+ * The Woodcock tracking regions might contain sub-regions: the volumes of these
+ * are excluded, i.e. Woodcock tracking stops at their boundary and the photons
+ * are tracked normally inside.
+ *
+ * Each thread has its own helper, but the (read-only) material voxel maps are
+ * built only by the helper of the master and shared by the worker threads.
  */
 
 class G4HepEmWoodcockHelper {
@@ -33,16 +41,27 @@ public:
    ~G4HepEmWoodcockHelper();
 
     // Returns true only if at least one Woodcock tracking region has been found
-    G4bool Initialize(std::vector<std::string>& wdtRegionNames, struct G4HepEmMatCutData* hepEmMatCutData, G4VPhysicalVolume* worldVolume);
+    // with a root volume that can be Woodcock tracked (the majorant cross section
+    // tables are built by using the HepEm data)
+    // NOTE: the kinetic energy limit needs to be set before as the tables are
+    //       built only above that.
+    G4bool Initialize(std::vector<std::string>& wdtRegionNames, const struct G4HepEmData* hepEmData, G4VPhysicalVolume* worldVolume);
 
 
-    void     SetKineticEnergyLimit(G4double val) { fWDTKineticEnergyLimit = val; }
+    // NOTE: the energy grid of the majorant tables starts from this limit
+    void     SetKineticEnergyLimit(G4double val);
     G4double GetKineticEnergyLimit() { return fWDTKineticEnergyLimit; }
 
+    // Size of the voxels of the material maps built for each root logical volume
+    // (0 means no voxel maps). NOTE: needs to be set before `Initialize`.
+    void     SetVoxelSize(G4double val) { fWDTVoxelSize = val; }
+    G4double GetVoxelSize() { return fWDTVoxelSize; }
+
 
     // Checks if this step will be done in a WDT region with high enough kinetic energy.
     // Finds the root volume of the region in chich this step will be done and
-    // sets the following fileds: fWDTTransform, fWDTHepEmIMC, fWDTSolid, fWDTCouple
+    // sets the following fileds: fWDTTransform, fWDTSolid, fWDTMajorantMXsec,
+    // fWDTVoxelMap, fWDTExclusionZones
     // Returns `false` is the step is not in a WDT region or the energy is too low.
     G4bool  FindWDTVolume(int regionID, const G4Track& aTrack);
 
@@ -53,42 +72,143 @@ public:
     // all relevant pre-step point infomatin is set to thier post-step point value
     // (as several volume boundaries might have been crossed between the pre- and
     // post step points and interaction can only happen at the post step point if any).
-    G4bool KeepTracking(const struct G4HepEmData* theHepEmData, G4HepEmGammaTrack* theGammaTrack, G4Track& aTrack);
+    // The random numbers are taken from the (buffered) HepEm random engine.
+    G4bool KeepTracking(const struct G4HepEmData* theHepEmData, G4HepEmGammaTrack* theGammaTrack,
+                        G4Track& aTrack, G4HepEmRandomEngine* rnge);
+
+    // Discards the random numbers left in the buffer (e.g. at the start of
+    // each track to keep reproducibility).
+    void DiscardRandoms() { fRandomIndex = kRandomBufferSize; }
+
+    // Builds the majorant macroscopic cross section table of the given root
+    // logical volume (of the given region) as for Woodcock tracking. Returns
+    // false (and an empty table) if the root cannot be Woodcock tracked. Also
+    // used by the `G4HepEmWoodcockProfiler` (independently of `Initialize`).
+    G4bool   BuildRootMajorantMXsec(G4LogicalVolume* rootLogVol, G4Region* region,
+                                    const struct G4HepEmData* hepEmData,
+                                    std::vector<G4double>& majorant);
+
+    // Majorant macroscopic cross section at the given energy from the given
+    // table (built by `BuildRootMajorantMXsec`).
+    G4double GetMajorantMXsec(const G4double* majorant, G4double ekin) const;
 
 
 private:
 
    void ClearData();
 
-   void FindWDTMaterial(G4LogicalVolume* lvol, double& maxDensity, G4Material** maxDensityMat);
+   // Sets up the energy grid of the majorant tables (see the kinetic energy limit).
+   void InitMajorantEnergyGrid();
+
+   // A volume of a sub-region inside a root logical volume: Woodcock tracking
+   // stops at its boundary (i.e. it's excluded) and normal tracking continues
+   // inside. The transformation is from the root local to the volume local frame.
+   struct WDTExclusionZone {
+     const G4VSolid*        fSolid;
+     G4AffineTransform      fTransform;
+   };
+
+   // Collects the (unique) G4HepEm material-cuts couple indices of all the
+   // materials of the given logical volume branch (in the given region). The
+   // daughter volumes that belong to another region (sub-region) are not
+   // visited but added to the exclusion zones (`rootToLocal` is the transform
+   // from the root to the `lvol` local frame that is valid only if all volumes
+   // along the path were normal placements, i.e. `isNormalPath`). Returns false
+   // if the branch cannot be Woodcock tracked (sub-region volume that is not a
+   // normal placement).
+   G4bool FindWDTMatCuts(G4LogicalVolume* lvol, G4Region* region,
+                         const struct G4HepEmMatCutData* hepEmMatCutData,
+                         std::vector<G4int>& hepEmIMCs,
+                         const G4AffineTransform& rootToLocal, G4bool isNormalPath,
+                         std::vector<WDTExclusionZone>& exclusionZones);
+
+   // Distance (along the given direction) to the boundary of the actual root
+   // volume or to the closest exclusion zone (from a point local to the root).
+   G4double DistanceToBoundary(const G4ThreeVector& localPoint,
+                               const G4ThreeVector& localDirection) const;
+
+   // Builds the majorant, i.e. the maximum of the total macroscopic cross
+   // sections of the given material-cuts couples, on the energy grid.
+   void BuildMajorantMXsec(const struct G4HepEmData* hepEmData,
+                           const std::vector<G4int>& hepEmIMCs,
+                           std::vector<G4double>& majorant) const;
+
+   // Majorant macroscopic cross section at the given energy (from the actual table)
+   G4double GetMajorantMXsec(G4double ekin) const { return GetMajorantMXsec(fWDTMajorantMXsec, ekin); }
+
+   // Returns the next random number of the buffer (refilled when it's empty).
+   G4double GetRandom(G4HepEmRandomEngine* rnge);
+
+   // A 3D map of the bounding box of a root logical volume (in its local frame)
+   // that stores the HepEm material-cuts couple index of each voxel if the whole
+   // voxel is within a single volume (-1 if the voxel is "mixed" and the point
+   // needs to be located by the navigator).
+   struct WDTVoxelMap {
+     G4int GetHepEmIMC(const G4ThreeVector& localPoint) const {
+       G4int indx = 0;
+       for (int i=0; i<3; ++i) {
+         if (localPoint[i] < fMin[i]) {
+           return -1;
+         }
+         const G4int iv = (G4int)((localPoint[i]-fMin[i])*fInvSize[i]);
+         if (iv >= fNumVoxels[i]) {
+           return -1;
+         }
+         indx = indx*fNumVoxels[i] + iv;
+       }
+       return fHepEmIMC[indx];
+     }
+     G4int                  fNumVoxels[3] = {0, 0, 0};
+     G4double               fMin[3]       = {0.0, 0.0, 0.0};
+     G4double               fInvSize[3]   = {0.0, 0.0, 0.0};
+     std::vector<G4int>     fHepEmIMC;           // couple index per voxel (-1: mixed)
+   };
+
+   // Builds the voxel map of the given root logical volume.
+   void BuildVoxelMap(const G4LogicalVolume* rootLogVol, const G4int* g4MCIndexToHepEmMCIndex,
+                      WDTVoxelMap& voxelMap);
+
+   // The voxel map of the given root logical volume built by the master helper
+   // (nullptr if this is the master or the master has no such map).
+   std::shared_ptr<const WDTVoxelMap> GetMasterVoxelMap(const G4LogicalVolume* rootLogVol) const;
+
+   // Finds the deepest logical volume, below the given one, that contains the
+   // given point (local to `lvol`) while updating `safety` with the isotropic
+   // safety of that point (i.e. distance to the closest volume boundary below
+   // `lvol`). Returns nullptr if a non-normal (e.g. replica) daughter is found.
+   const G4LogicalVolume* LocateInLogVol(const G4LogicalVolume* lvol,
+                                         const G4ThreeVector& localPoint,
+                                         G4double& safety) const;
 
 
    // One `WDTDataPerRootLogVol` data is structured for each root logical volume
-   // of a Woodcock tracking reagion: with a pointer to its solid, to the mat.-
-   // cuts couple of the "heaviest" material in this branch, i.e. below the root
-   // logical volume, and its corresponding G4HepEm material-cuts couple index.
+   // of a Woodcock tracking reagion: with a pointer to its solid and the table
+   // of the majorant total macroscopic cross section over the energy grid, i.e.
+   // the maximum over all materials in this branch (below the root logical vol.).
    struct WDTDataPerRootLogVol {
      WDTDataPerRootLogVol()
-     : fSolid(nullptr), fG4Couple(nullptr), fG4CoupleHepEmIndex(-1) {}
-     WDTDataPerRootLogVol(G4VSolid* solid, G4MaterialCutsCouple* couple, G4int hepEmIMC)
-     : fSolid(solid),   fG4Couple(couple),  fG4CoupleHepEmIndex(hepEmIMC) {}
+     : fSolid(nullptr), fRegionID(-1) {}
+     WDTDataPerRootLogVol(G4VSolid* solid, G4int regionID)
+     : fSolid(solid), fRegionID(regionID) {}
      G4VSolid*              fSolid;              // solid of the root logical vol.
-     G4MaterialCutsCouple*  fG4Couple;           // couple with the heaviest material
-     G4int                  fG4CoupleHepEmIndex; // G4HepEm mat-cut index of that
+     G4int                  fRegionID;           // ID of the WDT region of the root
+     std::vector<G4double>  fMajorantMXsec;      // majorant mac. xsec [fMajorantNumEnergies]
+     std::shared_ptr<const WDTVoxelMap> fVoxelMap; // material voxel map (if requested, shared)
+     std::vector<WDTExclusionZone> fExclusionZones; // sub-region volumes (if any)
    };
 
-   // All `WDTDataPerRootLogVol` that belongs to one Woodcock tracking region, i.e.
-   // as many as root logical volume of that region. Indexed by the ID of the
-   // root logical volume (i.e. that's the key).
-   struct WDTDataForARegion {
-     std::map<G4int, WDTDataPerRootLogVol*> fWDTDataRegion;
-   };
+   // Woodcock tracking related data for all root logical volumes of all regions
+   // where Woodcock tracking was requested by giving the name of the regions
+   // (and a detector region with that name has been found). All these data
+   // are initialised when the `Initialize` method is invoked.
+   std::vector<WDTDataPerRootLogVol> fWDTRootLogVolData;
 
-   // Woodcock tracking related data for all regions where Woodcock tracking was
-   // requested by giving the name of the regions (and a detector region with that
-   // name has been found). Indexed by the G4Region ID (i.e. that's the key).
-   // All these data are initialised when the `Initialize` method is invoked.
-   std::map<G4int, WDTDataForARegion*> fWDTData;
+   // Dense lookup tables used in each step (no tree lookups): flags indexed by
+   // the G4Region ID (true for WDT regions) and index of the root logical volume
+   // data in `fWDTRootLogVolData` indexed by the logical volume ID (-1 if the
+   // logical volume is not a root of a WDT region).
+   std::vector<G4bool>   fIsWDTRegion;
+   std::vector<G4int>    fWDTRootIndexPerLogVol;
 
    // Some data that are used during the Woodcock tracking and their values are
    // set accoring to the root logical volume inside which the actual tracking is
@@ -97,15 +217,37 @@ private:
    // inside the `FindRootVolume` method.
    // NOTE: none of these objects are owned
    G4VSolid*             fWDTSolid;
-   G4MaterialCutsCouple* fWDTCouple;
-   G4int                 fWDTHepEmIMC;
+   const G4double*       fWDTMajorantMXsec; // majorant table of the actual root vol.
+   const WDTVoxelMap*    fWDTVoxelMap;      // voxel map of the actual root vol. (if any)
+   const std::vector<WDTExclusionZone>* fWDTExclusionZones; // of the actual root vol.
    G4AffineTransform     fWDTTransform;  // transformation of the actual phy. vol.
 
+   // The log-spaced kinetic energy grid of the majorant tables: from the WDT
+   // kinetic energy limit to 100 TeV (same for all root logical volumes).
+   G4int                 fMajorantNumEnergies;
+   G4double              fMajorantLogEMin;
+   G4double              fMajorantInvLogDelta;
+
+   // The helper of the master thread (its voxel maps are shared by the workers).
+   static G4HepEmWoodcockHelper* gTheMasterWoodcockHelper;
+   G4bool                fIsMaster;
+
    // A navigator used to locate points (not to mess with the navigator for tarcking)
    G4Navigator           fWDTNavigator;
 
+   // Buffer of random numbers filled by the HepEm random engine in batches and
+   // the index of the next one to be used (buffer size means empty).
+   static constexpr G4int kRandomBufferSize = 16;
+   G4double              fRandomBuffer[kRandomBufferSize];
+   G4int                 fRandomIndex;
+
    // A kinetic energy limit below which Woodcock tracking is turned off.
    G4double              fWDTKineticEnergyLimit;
+
+   // Size of the voxels of the material maps (0 means no voxel maps) and the
+   // maximum number of voxels per map (the voxel size is increased if needed).
+   G4double              fWDTVoxelSize;
+   static constexpr G4double kMaxNumVoxels = 2097152; // 2^21
 };
 
 #endif // G4HepEmWoodcockHelper
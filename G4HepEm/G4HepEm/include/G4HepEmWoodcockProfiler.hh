@@ -0,0 +1,84 @@
+
+#ifndef G4HepEmWoodcockProfiler_h
+#define G4HepEmWoodcockProfiler_h 1
+
+#include "G4HepEmSharedAccumulator.hh"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class G4Track;
+class G4HepEmWoodcockHelper;
+struct G4HepEmData;
+
+/**
+ * @file    G4HepEmWoodcockProfiler.hh
+ * @class   G4HepEmWoodcockProfiler
+ * @date    2026
+ *
+ * Collects photon step statistics, filled directly by the `G4HepEmTrackingManager`,
+ * to help selecting the detector regions where Woodcock tracking is beneficial.
+ *
+ * The (normal, i.e. non-Woodcock) photon steps above the Woodcock tracking
+ * kinetic energy limit are recorded per root logical volume of all detector
+ * regions: the number and the summed length of the steps limited by geometry
+ * and by physics as well as the number of mean free paths travelled using the
+ * real and the majorant total macroscopic cross sections. The majorant is the
+ * same table that Woodcock tracking would use (built by a `G4HepEmWoodcockHelper`,
+ * see `BuildRootMajorantMXsec`). The roots that cannot be Woodcock tracked are
+ * not recorded.
+ *
+ * Woodcock tracking would remove the geometry limited steps while adding one
+ * point location per delta interaction, i.e. the difference of the majorant and
+ * the real number of mean free paths. The estimated number of saved navigation
+ * calls is then used to rank the root logical volumes (regions) in the report.
+ *
+ * The thread local statistics are merged into those of the master at the end of
+ * each event (see `G4HepEmSharedAccumulator`). The report can be printed by the
+ * master profiler (that can be obtained by `GetMasterProfiler`) in the master
+ * `EndOfRunAction`.
+ */
+
+class G4HepEmWoodcockProfiler : public G4HepEmSharedAccumulator<G4HepEmWoodcockProfiler, double> {
+public:
+  // The master owns the shared accumulator while the workers (`isMaster=false`)
+  // will merge their local statistics into that of the master. Steps are
+  // recorded only above `ekinLimit`.
+  G4HepEmWoodcockProfiler(bool isMaster, const struct G4HepEmData* hepEmData, double ekinLimit);
+ ~G4HepEmWoodcockProfiler();
+
+  static G4HepEmWoodcockProfiler* GetMasterProfiler() { return GetMaster(); }
+
+  // Records a normal photon step done in the volume given by the (pre-step)
+  // touchable of the track. `mxsec` is the real total macroscopic cross section.
+  void RecordStep(const G4Track& track, double ekin, double mxsec, double stepLength,
+                  bool isGeomLimited);
+
+  // Prints the ranked list of the root logical volumes (only the master).
+  void Report(std::ostream& os = std::cout) const;
+
+private:
+  // The quantities recorded per root logical volume.
+  enum Quantity { kNumGeomSteps = 0, kNumPhysSteps, kSumGeomStepLength,
+                  kSumPhysStepLength, kSumRealMFPs, kSumMajorantMFPs, kNumQuantities };
+
+private:
+  double                fEKinLimit;
+
+  // Index of the root data indexed by the logical volume instance ID (-1 if
+  // the logical volume is not a root) and the region, root logical volume
+  // names and majorant tables of the roots (empty if cannot be Woodcock tracked).
+  std::vector<int>                  fRootIndexPerLogVol;
+  std::vector<std::string>          fRegionNames;
+  std::vector<std::string>          fRootNames;
+  std::vector<std::vector<double>>  fRootMajorantMXsec;
+
+  // The helper that builds the majorant tables (used only for those).
+  std::unique_ptr<G4HepEmWoodcockHelper> fWDTHelper;
+
+  // The local data are the statistics [#roots x kNumQuantities].
+};
+
+#endif // G4HepEmWoodcockProfiler_h
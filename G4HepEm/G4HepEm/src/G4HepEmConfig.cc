@@ -4,13 +4,28 @@
 #include "G4HepEmParameters.hh"
 #include "G4HepEmParametersInit.hh"
 
+#include "G4Exception.hh"
 #include "G4RegionStore.hh"
 #include "G4Region.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <sstream>
 
 G4HepEmConfig::G4HepEmConfig() {
   fG4HepEmParameters = new G4HepEmParameters;
   fWDTEnergyLimit    = 0.2; // 200 keV by default
+  fWDTVoxelSize      = 0.0; // no voxel maps by default
+  fIsWDTProfiling    = false;
+  fScoringMeshType   = -1;  // no scoring mesh by default
+  fTransparentDensityThreshold = 0.0; // no transparent materials by default
+  fIsLeafVolumeShortcut = false;
+  fIsKernelRecordDirection = false;
+  for (int i=0; i<3; ++i) {
+    fScoringMeshNumBins[i] = 0;
+    fScoringMeshMin[i]     = 0.0;
+    fScoringMeshMax[i]     = 0.0;
+  }
   InitHepEmParameters(fG4HepEmParameters);
 }
 
@@ -35,6 +50,47 @@ void G4HepEmConfig::SetWoodcockTrackingRegion(const std::string& regionName, G4b
 }
 
 
+void G4HepEmConfig::SetHitAggregationRegion(const std::string& regionName, G4bool val) {
+  // same as for the Woodcock tracking regions: avoid duplications and remove
+  // if it was requested (i.e. `val=false`)
+  for (std::vector<std::string>::iterator it=fHitAggregationRegionNames.begin(); it != fHitAggregationRegionNames.end(); ++it) {
+    if (*it==regionName) {
+      if (!val) { fHitAggregationRegionNames.erase(it); }
+      return;
+    }
+  }
+  if (val) { fHitAggregationRegionNames.push_back(regionName); }
+}
+
+
+void G4HepEmConfig::SetCartesianScoringMesh(const G4ThreeVector& minXYZ, const G4ThreeVector& maxXYZ,
+                                            G4int nx, G4int ny, G4int nz) {
+  fScoringMeshType       = 0;
+  fScoringMeshNumBins[0] = nx;
+  fScoringMeshNumBins[1] = ny;
+  fScoringMeshNumBins[2] = nz;
+  for (int i=0; i<3; ++i) {
+    fScoringMeshMin[i] = minXYZ[i];
+    fScoringMeshMax[i] = maxXYZ[i];
+  }
+}
+
+
+void G4HepEmConfig::SetCylindricalScoringMesh(G4double rMax, G4double zMin, G4double zMax,
+                                              G4int nr, G4int nphi, G4int nz) {
+  fScoringMeshType       = 1;
+  fScoringMeshNumBins[0] = nr;
+  fScoringMeshNumBins[1] = nphi;
+  fScoringMeshNumBins[2] = nz;
+  fScoringMeshMin[0] = 0.0;
+  fScoringMeshMax[0] = rMax;
+  fScoringMeshMin[1] = 0.0;
+  fScoringMeshMax[1] = CLHEP::twopi;
+  fScoringMeshMin[2] = zMin;
+  fScoringMeshMax[2] = zMax;
+}
+
+
 void G4HepEmConfig::SetEnergyLossStepLimitFunctionParameters(G4double drRange, G4double finRange, const G4String& nameRegion) {
   if (nameRegion == "all") {
     SetEnergyLossStepLimitFunctionParameters(drRange, finRange);
@@ -179,6 +235,123 @@ G4bool G4HepEmConfig::GetApplyCuts(G4int indxRegion) {
 }
 
 
+
+void G4HepEmConfig::SetElectronTrackingCut(G4double val, const G4String& nameRegion) {
+  if (nameRegion == "all") {
+    SetElectronTrackingCut(val);
+  } else {
+    fG4HepEmParameters->fParametersPerRegion[GetRegionIndex(nameRegion)].fElectronTrackingCut = val;
+  }
+}
+void G4HepEmConfig::SetElectronTrackingCut(G4double val) {
+  for (int i=0; i<fG4HepEmParameters->fNumRegions; ++i)
+    fG4HepEmParameters->fParametersPerRegion[i].fElectronTrackingCut = val;
+}
+G4double G4HepEmConfig::GetElectronTrackingCut(const G4String& nameRegion) {
+  return GetElectronTrackingCut(GetRegionIndex(nameRegion));
+}
+G4double G4HepEmConfig::GetElectronTrackingCut(G4int indxRegion) {
+  CheckRegionIndex(indxRegion);
+  return fG4HepEmParameters->fParametersPerRegion[indxRegion].fElectronTrackingCut;
+}
+
+
+
+void G4HepEmConfig::SetGammaTrackingCut(G4double val, const G4String& nameRegion) {
+  if (nameRegion == "all") {
+    SetGammaTrackingCut(val);
+  } else {
+    fG4HepEmParameters->fParametersPerRegion[GetRegionIndex(nameRegion)].fGammaTrackingCut = val;
+  }
+}
+void G4HepEmConfig::SetGammaTrackingCut(G4double val) {
+  for (int i=0; i<fG4HepEmParameters->fNumRegions; ++i)
+    fG4HepEmParameters->fParametersPerRegion[i].fGammaTrackingCut = val;
+}
+G4double G4HepEmConfig::GetGammaTrackingCut(const G4String& nameRegion) {
+  return GetGammaTrackingCut(GetRegionIndex(nameRegion));
+}
+G4double G4HepEmConfig::GetGammaTrackingCut(G4int indxRegion) {
+  CheckRegionIndex(indxRegion);
+  return fG4HepEmParameters->fParametersPerRegion[indxRegion].fGammaTrackingCut;
+}
+
+
+
+void G4HepEmConfig::SetWeightWindow(G4double lower, G4double upper, G4double survival, const G4String& nameRegion) {
+  if (nameRegion == "all") {
+    SetWeightWindow(lower, upper, survival);
+  } else {
+    const G4double theSurvival = CheckWeightWindow(lower, upper, survival);
+    G4HepEmRegionParmeters& rDat = fG4HepEmParameters->fParametersPerRegion[GetRegionIndex(nameRegion)];
+    rDat.fWeightWindowLower    = lower;
+    rDat.fWeightWindowUpper    = upper;
+    rDat.fWeightWindowSurvival = theSurvival;
+  }
+}
+void G4HepEmConfig::SetWeightWindow(G4double lower, G4double upper, G4double survival) {
+  const G4double theSurvival = CheckWeightWindow(lower, upper, survival);
+  for (int i=0; i<fG4HepEmParameters->fNumRegions; ++i) {
+    G4HepEmRegionParmeters& rDat = fG4HepEmParameters->fParametersPerRegion[i];
+    rDat.fWeightWindowLower    = lower;
+    rDat.fWeightWindowUpper    = upper;
+    rDat.fWeightWindowSurvival = theSurvival;
+  }
+}
+void G4HepEmConfig::GetWeightWindow(const G4String& nameRegion, G4double& lower, G4double& upper, G4double& survival) {
+  GetWeightWindow(GetRegionIndex(nameRegion), lower, upper, survival);
+}
+void G4HepEmConfig::GetWeightWindow(G4int indxRegion, G4double& lower, G4double& upper, G4double& survival) {
+  CheckRegionIndex(indxRegion);
+  const G4HepEmRegionParmeters& rDat = fG4HepEmParameters->fParametersPerRegion[indxRegion];
+  lower    = rDat.fWeightWindowLower;
+  upper    = rDat.fWeightWindowUpper;
+  survival = rDat.fWeightWindowSurvival;
+}
+
+
+
+void G4HepEmConfig::SetBremSplitting(G4int num, const G4String& nameRegion) {
+  if (nameRegion == "all") {
+    SetBremSplitting(num);
+  } else {
+    fG4HepEmParameters->fParametersPerRegion[GetRegionIndex(nameRegion)].fBremSplittingNum = std::max(1, num);
+  }
+}
+void G4HepEmConfig::SetBremSplitting(G4int num) {
+  for (int i=0; i<fG4HepEmParameters->fNumRegions; ++i)
+    fG4HepEmParameters->fParametersPerRegion[i].fBremSplittingNum = std::max(1, num);
+}
+G4int G4HepEmConfig::GetBremSplitting(const G4String& nameRegion) {
+  return GetBremSplitting(GetRegionIndex(nameRegion));
+}
+G4int G4HepEmConfig::GetBremSplitting(G4int indxRegion) {
+  CheckRegionIndex(indxRegion);
+  return fG4HepEmParameters->fParametersPerRegion[indxRegion].fBremSplittingNum;
+}
+
+
+
+void G4HepEmConfig::SetLeadingParticleBiasing(G4bool val, const G4String& nameRegion) {
+  if (nameRegion == "all") {
+    SetLeadingParticleBiasing(val);
+  } else {
+    fG4HepEmParameters->fParametersPerRegion[GetRegionIndex(nameRegion)].fIsLeadingParticleBiasing = val;
+  }
+}
+void G4HepEmConfig::SetLeadingParticleBiasing(G4bool val) {
+  for (int i=0; i<fG4HepEmParameters->fNumRegions; ++i)
+    fG4HepEmParameters->fParametersPerRegion[i].fIsLeadingParticleBiasing = val;
+}
+G4bool G4HepEmConfig::GetLeadingParticleBiasing(const G4String& nameRegion) {
+  return GetLeadingParticleBiasing(GetRegionIndex(nameRegion));
+}
+G4bool G4HepEmConfig::GetLeadingParticleBiasing(G4int indxRegion) {
+  CheckRegionIndex(indxRegion);
+  return fG4HepEmParameters->fParametersPerRegion[indxRegion].fIsLeadingParticleBiasing;
+}
+
+
 G4int G4HepEmConfig::GetRegionIndex(const G4String& nameRegion) {
   G4Region* region = G4RegionStore::GetInstance()->GetRegion(nameRegion, false);
   if (region == nullptr) {
@@ -201,6 +374,28 @@ void  G4HepEmConfig::CheckRegionIndex(G4int indxRegion) {
 }
 
 
+G4double G4HepEmConfig::CheckWeightWindow(G4double lower, G4double upper, G4double survival) {
+  // the default survival weight: the middle of the window or its lower bound
+  const G4double theSurvival = survival > 0.0 ? survival : (upper > 0.0 ? 0.5*(lower+upper) : lower);
+  std::ostringstream msg;
+  if (lower <= 0.0) {
+    msg << "The lower bound of the weight window ( = " << lower << " ) must be positive.";
+  } else if (upper != 0.0 && upper <= lower) {
+    msg << "The upper bound of the weight window ( = " << upper << " ) must be either zero (no splitting)"
+        << " or above the lower bound ( = " << lower << " ).";
+  } else if (theSurvival < lower) {
+    // the roulette would bias the weight: tracks below `lower` but above the
+    // survival weight would survive always while loosing weight
+    msg << "The survival weight of the weight window ( = " << theSurvival << " ) must not be below"
+        << " the lower bound ( = " << lower << " ).";
+  }
+  if (!msg.str().empty()) {
+    G4Exception("G4HepEmConfig::SetWeightWindow", "G4HepEm001", FatalException, msg.str().c_str());
+  }
+  return theSurvival;
+}
+
+
 void G4HepEmConfig::Dump() {
   const int width = 34;
   std::cout << "\n ======================== G4HepEmConfig ======================= " << std::endl;
@@ -229,6 +424,34 @@ void G4HepEmConfig::Dump() {
             << std::setw(5) << std::right
             << fWDTEnergyLimit/CLHEP::keV
             << " [keV] " << std::endl;
+  std::cout << std::left << std::setw(width) << " Woodcock tracking voxel size " << " : "
+            << std::setw(5) << std::right
+            << fWDTVoxelSize/CLHEP::mm
+            << " [mm] " << std::endl;
+  std::cout << std::left << std::setw(width) << " Woodcock tracking profiling " << " : "
+            << std::setw(5) << std::right
+            << fIsWDTProfiling
+            << " (true/false) "<< std::endl;
+  std::cout << std::left << std::setw(width) << " Transparent density threshold " << " : "
+            << std::setw(5) << std::right
+            << fTransparentDensityThreshold/(CLHEP::g/CLHEP::cm3)
+            << " [g/cm3] " << std::endl;
+  std::cout << std::left << std::setw(width) << " Leaf volume navigation shortcut " << " : "
+            << std::setw(5) << std::right
+            << fIsLeafVolumeShortcut
+            << " (true/false) "<< std::endl;
+  std::cout << std::left << std::setw(width) << " Kernel input recording " << " : "
+            << std::setw(5) << std::right
+            << (fKernelRecordFileName.empty() ? "none" : fKernelRecordFileName)
+            << (fIsKernelRecordDirection ? " (with direction)" : "") << std::endl;
+  std::cout << std::left << std::setw(width) << " Scoring mesh " << " : "
+            << std::setw(5) << std::right
+            << (fScoringMeshType < 0 ? "none" : (fScoringMeshType == 0 ? "Cartesian" : "cylindrical"));
+  if (fScoringMeshType >= 0) {
+    std::cout << " (" << fScoringMeshNumBins[0] << " x " << fScoringMeshNumBins[1]
+              << " x " << fScoringMeshNumBins[2] << " bins)";
+  }
+  std::cout << std::endl;
   std::cout << std::left << std::setw(width) << " Linear loss limit " << " : "
             << std::setw(5) << std::right
             << fG4HepEmParameters->fParametersPerRegion[0].fLinELossLimit*100
@@ -248,7 +471,10 @@ void G4HepEmConfig::Dump() {
 
   std::vector<G4String> names = {" FinalRange (mm)", " DRoverRange", " Energy loss fluctuation",
         " MSC Range factor",  " MSC Safety factor", " MSC minimal step limit",
-        " Multiple steps in MSC+Trans.", " Woodcock-tracking", " Apply cuts"};
+        " Multiple steps in MSC+Trans.", " Woodcock-tracking", " Apply cuts", " Hit aggregation",
+        " e-/e+ tracking cut (keV)", " Gamma tracking cut (keV)",
+        " Weight window (lower/upper)", " Brem splitting number",
+        " Leading particle biasing"};
   const int numParams  = names.size();
 
   for (int ip=0; ip<numParams; ++ip) {
@@ -259,6 +485,7 @@ void G4HepEmConfig::Dump() {
       std::cout << std::right << std::setw(lengthNameRegions[ir]);
 
       bool isWDT = false;
+      bool isHitAggregation = false;
       const G4String& regionName =  (*G4RegionStore::GetInstance())[ir]->GetName();
       if (ip==7) {
         for (std::vector<std::string>::iterator it=fWDTRegionNames.begin(); it != fWDTRegionNames.end(); ++it) {
@@ -268,6 +495,14 @@ void G4HepEmConfig::Dump() {
           }
         }
       }
+      if (ip==9) {
+        for (std::vector<std::string>::iterator it=fHitAggregationRegionNames.begin(); it != fHitAggregationRegionNames.end(); ++it) {
+          if (*it==regionName) {
+            isHitAggregation = true;
+            break;
+          }
+        }
+      }
 
       switch (ip) {
         case 0: std::cout << fG4HepEmParameters->fParametersPerRegion[ir].fFinalRange/CLHEP::mm << " | ";
@@ -288,6 +523,27 @@ void G4HepEmConfig::Dump() {
                 break;
         case 8: std::cout << fG4HepEmParameters->fParametersPerRegion[ir].fIsApplyCuts << " | ";
                 break;
+        case 9: std::cout << isHitAggregation << " | ";
+                break;
+        case 10: std::cout << fG4HepEmParameters->fParametersPerRegion[ir].fElectronTrackingCut/CLHEP::keV << " | ";
+                break;
+        case 11: std::cout << fG4HepEmParameters->fParametersPerRegion[ir].fGammaTrackingCut/CLHEP::keV << " | ";
+                break;
+        case 12: {
+                 const G4HepEmRegionParmeters& rDat = fG4HepEmParameters->fParametersPerRegion[ir];
+                 std::ostringstream strWW;
+                 if (rDat.fWeightWindowLower > 0.0) {
+                   strWW << rDat.fWeightWindowLower << "/" << rDat.fWeightWindowUpper;
+                 } else {
+                   strWW << "-";
+                 }
+                 std::cout << strWW.str() << " | ";
+                 break;
+                 }
+        case 13: std::cout << fG4HepEmParameters->fParametersPerRegion[ir].fBremSplittingNum << " | ";
+                break;
+        case 14: std::cout << fG4HepEmParameters->fParametersPerRegion[ir].fIsLeadingParticleBiasing << " | ";
+                break;
 
       }
     }
@@ -0,0 +1,70 @@
+
+#include "G4HepEmHitAggregator.hh"
+
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4StepStatus.hh"
+#include "G4Track.hh"
+#include "G4VSensitiveDetector.hh"
+
+
+G4HepEmHitAggregator::G4HepEmHitAggregator()
+: fStep(new G4Step), fSD(nullptr) {
+  fStep->NewSecondaryVector();
+}
+
+
+G4HepEmHitAggregator::~G4HepEmHitAggregator() {
+  delete fStep;
+}
+
+
+void G4HepEmHitAggregator::Invoke(G4VSensitiveDetector* sensitive, G4Step& step, G4bool isAggregate) {
+  if (!isAggregate) {
+    // keep the order of the hits: the pending aggregated step goes first
+    Flush();
+    sensitive->Hit(&step);
+    return;
+  }
+  G4Step& aggStep = *fStep;
+  // The pending aggregated step can be continued only if this step starts
+  // where that ended, i.e. same track in the same touchable with the same SD,
+  // and with the same weight (might be changed by leading particle biasing).
+  if (fSD != nullptr &&
+      (fSD != sensitive || aggStep.GetTrack() != step.GetTrack() ||
+       aggStep.GetPostStepPoint()->GetTouchable() != step.GetPreStepPoint()->GetTouchable() ||
+       aggStep.GetPreStepPoint()->GetWeight() != step.GetPreStepPoint()->GetWeight())) {
+    Flush();
+  }
+  if (fSD == nullptr) {
+    // start a new aggregated step: the first pre-step point is kept
+    *aggStep.GetPreStepPoint() = *step.GetPreStepPoint();
+    aggStep.SetTrack(step.GetTrack());
+    aggStep.SetStepLength(0.0);
+    aggStep.ResetTotalEnergyDeposit();
+    aggStep.SetNonIonizingEnergyDeposit(0.0);
+    aggStep.SetControlFlag(step.GetControlFlag());
+    fSD = sensitive;
+  }
+  // the last post-step point is kept while step length and edep are summed up
+  *aggStep.GetPostStepPoint() = *step.GetPostStepPoint();
+  aggStep.SetStepLength(aggStep.GetStepLength() + step.GetStepLength());
+  aggStep.AddTotalEnergyDeposit(step.GetTotalEnergyDeposit());
+  aggStep.AddNonIonizingEnergyDeposit(step.GetNonIonizingEnergyDeposit());
+  // Hand over to the SD if the track is leaving the touchable or it's the last step.
+  if (step.GetPostStepPoint()->GetStepStatus() == G4StepStatus::fGeomBoundary ||
+      step.GetTrack()->GetTrackStatus() != fAlive) {
+    Flush();
+  }
+}
+
+
+void G4HepEmHitAggregator::Flush() {
+  if (fSD == nullptr) {
+    return;
+  }
+  // reset first: the SD might trigger further hits (e.g. via user code)
+  G4VSensitiveDetector* sensitive = fSD;
+  fSD = nullptr;
+  sensitive->Hit(fStep);
+}
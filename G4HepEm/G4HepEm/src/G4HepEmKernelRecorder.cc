@@ -0,0 +1,49 @@
+
+#include "G4HepEmKernelRecorder.hh"
+
+#include "G4HepEmState.hh"
+#include "G4HepEmDataJsonIO.hh"
+
+#include <cstdlib>
+#include <iostream>
+
+G4HepEmKernelRecorder::G4HepEmKernelRecorder(const std::string& fileName, bool isWithDirection, std::size_t bufferSize)
+: fIsWithDirection(isWithDirection), fOutFile(fileName, std::ios::binary),
+  fBuffer(std::max(bufferSize, sizeof(G4HepEmKernelRecord) + 3*sizeof(float))), fBufferPos(0) {
+  if (!fOutFile) {
+    std::cerr << " *** ERROR in G4HepEmKernelRecorder: cannot open the record file = "
+              << fileName << std::endl;
+    exit(-1);
+  }
+  G4HepEmKernelRecordHeader header;
+  header.fFlags = fIsWithDirection ? G4HepEmKernelRecordHeader::kIsWithDirection : 0;
+  Append(&header, sizeof(header));
+}
+
+
+G4HepEmKernelRecorder::~G4HepEmKernelRecorder() {
+  Flush();
+}
+
+
+void G4HepEmKernelRecorder::Flush() {
+  if (fBufferPos > 0) {
+    fOutFile.write(fBuffer.data(), fBufferPos);
+    fOutFile.flush();
+    fBufferPos = 0;
+  }
+}
+
+
+bool G4HepEmKernelRecorder::WriteState(const std::string& fileName, G4HepEmData* hepEmData, G4HepEmParameters* hepEmPars) {
+  std::ofstream outf(fileName);
+  if (!outf) {
+    std::cerr << " *** ERROR in G4HepEmKernelRecorder::WriteState: cannot open file = "
+              << fileName << std::endl;
+    return false;
+  }
+  G4HepEmState state;
+  state.fData       = hepEmData;
+  state.fParameters = hepEmPars;
+  return G4HepEmStateToJson(outf, &state);
+}
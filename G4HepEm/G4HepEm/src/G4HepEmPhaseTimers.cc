@@ -0,0 +1,96 @@
+
+#include "G4HepEmPhaseTimers.hh"
+
+#include "G4HepEmData.hh"
+#include "G4HepEmMatCutData.hh"
+
+#include "G4Material.hh"
+#include "G4MaterialCutsCouple.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+
+#include <algorithm>
+#include <iomanip>
+
+G4HepEmPhaseTimers::G4HepEmPhaseTimers(bool isMaster, const struct G4HepEmData* hepEmData, int samplingPeriod)
+: G4HepEmSharedAccumulator(isMaster), fIsSampled(false), fSamplingPeriod(std::max(1, samplingPeriod)),
+  fStepCounter(0), fStartTime(0) {
+  // Names of the region and material of the HepEm material-cuts couples
+  const G4HepEmMatCutData* theMatCutData = hepEmData->fTheMatCutData;
+  const int numCouples = theMatCutData->fNumMatCutData;
+  fRegionNames.resize(numCouples, "");
+  fMaterialNames.resize(numCouples, "");
+  const G4ProductionCutsTable* theCutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  for (int imc=0; imc<numCouples; ++imc) {
+    const G4HepEmMCCData& mcData = theMatCutData->fMatCutData[imc];
+    fMaterialNames[imc] = theCutsTable->GetMaterialCutsCouple(mcData.fG4MatCutIndex)->GetMaterial()->GetName();
+    for (const G4Region* region : *G4RegionStore::GetInstance()) {
+      if (region->GetInstanceID() == mcData.fG4RegionIndex) {
+        fRegionNames[imc] = region->GetName();
+        break;
+      }
+    }
+  }
+  InitSharedAccumulator(numCouples*kNumPhases, "G4HepEmPhaseTimers");
+}
+
+
+void G4HepEmPhaseTimers::Report(std::ostream& os) const {
+  if (!IsMaster()) {
+    return;
+  }
+  const char* phaseNames[kNumPhases] = {"navigation", "safety", "howfar", "continuous",
+                                        "discrete", "user/SD", "stacking"};
+  // Estimated times [s] (sampled times scaled by the sampling period) and their
+  // totals per couple and phase.
+  const int numCouples = fRegionNames.size();
+  const double scale = 1.0E-9*fSamplingPeriod;
+  std::vector<double> totalPerCouple(numCouples, 0.0);
+  std::vector<double> totalPerPhase(kNumPhases, 0.0);
+  double total = 0.0;
+  std::vector<int> indices;
+  for (int imc=0; imc<numCouples; ++imc) {
+    for (int ip=0; ip<kNumPhases; ++ip) {
+      const double t = scale*GetSharedData(imc*kNumPhases + ip);
+      totalPerCouple[imc] += t;
+      totalPerPhase[ip]   += t;
+    }
+    total += totalPerCouple[imc];
+    if (totalPerCouple[imc] > 0.0) {
+      indices.push_back(imc);
+    }
+  }
+  std::sort(indices.begin(), indices.end(), [&totalPerCouple](int a, int b) { return totalPerCouple[a] > totalPerCouple[b]; });
+  os << "\n ===================================================================================================================== \n"
+     << "  G4HepEm tracking phase timers: estimated time [s] per material-cuts couple and phase (1 of "
+     << fSamplingPeriod << " steps sampled) \n"
+     << " ===================================================================================================================== \n";
+  os << std::left << std::setw(20) << " Region" << std::setw(20) << " Material" << std::right;
+  for (int ip=0; ip<kNumPhases; ++ip) {
+    os << std::setw(11) << phaseNames[ip];
+  }
+  os << std::setw(11) << "total" << std::setw(8) << "[%]" << std::endl;
+  os << std::fixed;
+  for (const int imc : indices) {
+    os << std::left << " " << std::setw(19) << fRegionNames[imc].substr(0, 18)
+       << " " << std::setw(19) << fMaterialNames[imc].substr(0, 18) << std::right;
+    for (int ip=0; ip<kNumPhases; ++ip) {
+      os << std::setw(11) << std::setprecision(3) << scale*GetSharedData(imc*kNumPhases + ip);
+    }
+    os << std::setw(11) << totalPerCouple[imc]
+       << std::setw(8) << std::setprecision(1) << (total > 0.0 ? 100.0*totalPerCouple[imc]/total : 0.0)
+       << std::endl;
+  }
+  os << std::left << std::setw(40) << " Total" << std::right;
+  for (int ip=0; ip<kNumPhases; ++ip) {
+    os << std::setw(11) << std::setprecision(3) << totalPerPhase[ip];
+  }
+  os << std::setw(11) << total << std::setw(8) << std::setprecision(1) << (total > 0.0 ? 100.0 : 0.0) << std::endl;
+  os << std::left << std::setw(40) << " [%]" << std::right;
+  for (int ip=0; ip<kNumPhases; ++ip) {
+    os << std::setw(11) << (total > 0.0 ? 100.0*totalPerPhase[ip]/total : 0.0);
+  }
+  os << std::defaultfloat << "\n ===================================================================================================================== \n"
+     << std::endl;
+}
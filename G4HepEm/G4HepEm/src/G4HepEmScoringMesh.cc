@@ -0,0 +1,78 @@
+
+#include "G4HepEmScoringMesh.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+
+G4HepEmScoringMesh::G4HepEmScoringMesh(bool isMaster, MeshType type, const int nbins[3],
+                                       const double minVals[3], const double maxVals[3])
+: G4HepEmSharedAccumulator(isMaster), fType(type) {
+  for (int i=0; i<3; ++i) {
+    fNumBins[i]  = nbins[i] > 0 ? nbins[i] : 1;
+    fMin[i]      = minVals[i];
+    fMax[i]      = maxVals[i];
+    fInvDelta[i] = fMax[i] > fMin[i] ? fNumBins[i]/(fMax[i]-fMin[i]) : 0.0;
+  }
+  InitSharedAccumulator(GetTotalNumBins(), "G4HepEmScoringMesh");
+}
+
+
+int G4HepEmScoringMesh::GetBinIndex(double x, double y, double z) const {
+  double u[3] = {x, y, z};
+  if (fType == kCylindrical) {
+    u[0] = std::sqrt(x*x + y*y);
+    u[1] = std::atan2(y, x);
+    if (u[1] < 0.0) {
+      u[1] += 6.283185307179586; // 2pi
+    }
+  }
+  int indx = 0;
+  for (int i=0; i<3; ++i) {
+    if (u[i] < fMin[i] || u[i] >= fMax[i]) {
+      return -1;
+    }
+    int ib = static_cast<int>((u[i]-fMin[i])*fInvDelta[i]);
+    ib = ib < fNumBins[i] ? ib : fNumBins[i]-1;
+    indx = indx*fNumBins[i] + ib;
+  }
+  return indx;
+}
+
+
+void G4HepEmScoringMesh::Merge() {
+  for (const int indx : fTouchedBins) {
+    MergeData(indx);
+  }
+  fTouchedBins.clear();
+}
+
+
+bool G4HepEmScoringMesh::Write(const std::string& fileName) const {
+  std::ofstream outf(fileName, std::ios::binary);
+  if (!outf) {
+    std::cerr << " *** ERROR in G4HepEmScoringMesh::Write: cannot open file = "
+              << fileName << std::endl;
+    return false;
+  }
+  const char    magic[8] = {'G','4','H','E','M','E','S','H'};
+  const int32_t version  = 1;
+  const int32_t type     = static_cast<int32_t>(fType);
+  outf.write(magic, sizeof(magic));
+  outf.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  outf.write(reinterpret_cast<const char*>(&type), sizeof(type));
+  for (int i=0; i<3; ++i) {
+    const int32_t nbins = fNumBins[i];
+    outf.write(reinterpret_cast<const char*>(&nbins), sizeof(nbins));
+    outf.write(reinterpret_cast<const char*>(&fMin[i]), sizeof(double));
+    outf.write(reinterpret_cast<const char*>(&fMax[i]), sizeof(double));
+  }
+  const int numBins = GetTotalNumBins();
+  std::vector<double> values(numBins);
+  for (int i=0; i<numBins; ++i) {
+    values[i] = GetValue(i);
+  }
+  outf.write(reinterpret_cast<const char*>(values.data()), numBins*sizeof(double));
+  return static_cast<bool>(outf);
+}
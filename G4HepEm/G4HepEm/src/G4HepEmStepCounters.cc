@@ -0,0 +1,85 @@
+
+#include "G4HepEmStepCounters.hh"
+
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+
+#include <algorithm>
+#include <fstream>
+
+G4HepEmStepCounters::G4HepEmStepCounters(bool isMaster)
+: G4HepEmSharedAccumulator(isMaster), fNumRegions(0) {
+  // The regions are indexed by their instance ID
+  for (const G4Region* region : *G4RegionStore::GetInstance()) {
+    fNumRegions = std::max(fNumRegions, region->GetInstanceID()+1);
+  }
+  fRegionNames.resize(fNumRegions, "");
+  for (const G4Region* region : *G4RegionStore::GetInstance()) {
+    fRegionNames[region->GetInstanceID()] = region->GetName();
+  }
+  InitSharedAccumulator(fNumRegions*3*kNumCounters, "G4HepEmStepCounters");
+}
+
+
+void G4HepEmStepCounters::WriteJSON(std::ostream& os) const {
+  if (!IsMaster()) {
+    return;
+  }
+  const char* particleNames[3] = {"e-", "e+", "gamma"};
+  const std::vector<std::string> slotNames[3] = {
+    {"Transportation", "other", "eIoni", "eBrem", "annihl", "msc", "electronNuclear", "positronNuclear"},
+    {"Transportation", "other", "eIoni", "eBrem", "annihl", "msc", "electronNuclear", "positronNuclear"},
+    {"Transportation", "other", "conv", "compt", "phot", "photonNuclear"}
+  };
+  auto writeSlots = [this, &os](int indx, const std::vector<std::string>& names) {
+    os << "{";
+    for (std::size_t is=0; is<names.size(); ++is) {
+      os << (is > 0 ? ", " : "") << "\"" << names[is] << "\": " << GetSharedData(indx + is);
+    }
+    os << "}";
+  };
+  os << "{\n  \"step_length_histogram\": {\"log10_min_mm\": " << kHistLog10Min
+     << ", \"bins_per_decade\": " << kHistBinsPerDecade
+     << ", \"num_bins\": " << kNumHistBins << "},\n"
+     << "  \"regions\": [";
+  bool isFirstRegion = true;
+  for (int ir=0; ir<fNumRegions; ++ir) {
+    if (fRegionNames[ir].empty()) {
+      continue;
+    }
+    os << (isFirstRegion ? "\n" : ",\n")
+       << "    {\"name\": \"" << fRegionNames[ir] << "\", \"particles\": {";
+    isFirstRegion = false;
+    for (int ip=0; ip<3; ++ip) {
+      const int indx = (ir*3 + ip)*kNumCounters;
+      os << (ip > 0 ? "," : "") << "\n      \"" << particleNames[ip] << "\": {"
+         << "\"steps\": " << GetSharedData(indx + kSteps)
+         << ", \"msc_substeps\": " << GetSharedData(indx + kMSCSubSteps)
+         << ", \"secondaries_produced\": " << GetSharedData(indx + kSecProduced)
+         << ", \"secondaries_killed_by_cuts\": " << GetSharedData(indx + kSecKilled)
+         << ",\n        \"limited_by\": ";
+      writeSlots(indx + kLimitedBy, slotNames[ip]);
+      os << ",\n        \"interactions\": ";
+      writeSlots(indx + kInteractions, slotNames[ip]);
+      os << ",\n        \"step_length_histogram\": [";
+      for (int ib=0; ib<kNumHistBins; ++ib) {
+        os << (ib > 0 ? ", " : "") << GetSharedData(indx + kHist + ib);
+      }
+      os << "]}";
+    }
+    os << "\n    }}";
+  }
+  os << "\n  ]\n}" << std::endl;
+}
+
+
+bool G4HepEmStepCounters::WriteJSON(const std::string& fileName) const {
+  std::ofstream outf(fileName);
+  if (!outf) {
+    std::cerr << " *** ERROR in G4HepEmStepCounters::WriteJSON: cannot open file = "
+              << fileName << std::endl;
+    return false;
+  }
+  WriteJSON(outf);
+  return static_cast<bool>(outf);
+}
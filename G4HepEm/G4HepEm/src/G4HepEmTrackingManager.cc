@@ -5,19 +5,40 @@
 
 #include "G4HepEmNoProcess.hh"
 #include "G4HepEmConfig.hh"
+#include "G4HepEmScoringMesh.hh"
+#include "G4HepEmWoodcockProfiler.hh"
+#include "G4HepEmKernelRecorder.hh"
+#include "G4HepEmHitAggregator.hh"
+#ifdef G4HepEm_STEP_COUNTERS
+#include "G4HepEmStepCounters.hh"
+#endif
+// Timing of the tracking phases (only with the `G4HepEm_PHASE_TIMERS` option)
+#ifdef G4HepEm_PHASE_TIMERS
+#include "G4HepEmPhaseTimers.hh"
+#define G4HepEm_TIMER_START_STEP() fPhaseTimers->StartStep()
+#define G4HepEm_TIMER_START() fPhaseTimers->Start()
+#define G4HepEm_TIMER_STOP(phase, imc) fPhaseTimers->Stop(G4HepEmPhaseTimers::phase, imc)
+#else
+#define G4HepEm_TIMER_START_STEP()
+#define G4HepEm_TIMER_START()
+#define G4HepEm_TIMER_STOP(phase, imc)
+#endif
 
 #include "G4HepEmRandomEngine.hh"
 #include "G4HepEmData.hh"
 #include "G4HepEmParameters.hh"
 #include "G4HepEmMatCutData.hh"
+#include "G4HepEmMaterialData.hh"
 #include "G4HepEmRunManager.hh"
 #include "G4HepEmTLData.hh"
 
 #include "G4HepEmElectronManager.hh"
+#include "G4HepEmProbes.hh"
 #include "G4HepEmElectronTrack.hh"
 #include "G4HepEmPositronInteractionAnnihilation.hh"
 #include "G4HepEmGammaManager.hh"
 #include "G4HepEmGammaTrack.hh"
+#include "G4HepEmWeightWindow.hh"
 
 #include "G4Version.hh"
 #include "G4MaterialCutsCouple.hh"
@@ -27,6 +48,7 @@
 #include "G4Threading.hh"
 #include "G4Track.hh"
 #include "G4TrackingManager.hh"
+#include "G4VSensitiveDetector.hh"
 #include "G4VTrajectory.hh"
 
 #include "G4SafetyHelper.hh"
@@ -45,6 +67,8 @@
 #include "G4TransportationProcessType.hh"
 
 #include "G4RegionStore.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4UserLimits.hh"
 
 #include "G4Electron.hh"
 #include "G4Gamma.hh"
@@ -99,6 +123,9 @@ G4HepEmTrackingManager::G4HepEmTrackingManager(G4int verbose) {
   fTransportNoProcess = new G4HepEmNoProcess(
       "Transportation", G4ProcessType::fTransportation, TRANSPORTATION);
 
+  fWeightWindowNoProcess = new G4HepEmNoProcess(
+      "weightWindow", G4ProcessType::fGeneral);
+
   // Init the gamma-nuclear process
   fGNucProcess = nullptr;
   // Init the electron/positron-nuclear processes
@@ -110,6 +137,13 @@ G4HepEmTrackingManager::G4HepEmTrackingManager(G4int verbose) {
   fFastSimProcess[1] = nullptr;
   fFastSimProcess[2] = nullptr;
 
+  // Init the user limits related process ptrs and flags of the 3 particles
+  for (int ip=0; ip<3; ++ip) {
+    fStepLimiterProcess[ip]     = nullptr;
+    fUserSpecialCutsProcess[ip] = nullptr;
+    fIsUserLimits[ip]           = false;
+  }
+
   // ATLAS XTR RELATED:
   // Init the ATLAS specific transition radiation process related ptrs
   // NOTE: they stay `nullptr` if used outside ATLAS Athena causing no harm
@@ -119,6 +153,35 @@ G4HepEmTrackingManager::G4HepEmTrackingManager(G4int verbose) {
   // Woodcock tracking helper (will be created only if Woodcock tracking was asked)
   fWDTHelper = nullptr;
 
+  // Hit aggregation (will be activated only if it was asked in any regions)
+  fIsHitAggregation = false;
+  fHitAggregator    = new G4HepEmHitAggregator;
+
+  // Scoring mesh (will be created only if it was requested)
+  fScoringMesh = nullptr;
+
+  // Woodcock tracking profiler (will be created only if it was requested)
+  fWDTProfiler = nullptr;
+
+  // Kernel input recorder (will be created only if it was requested)
+  fKernelRecorder = nullptr;
+  fIsKernelStateWritten = false;
+
+#ifdef G4HepEm_STEP_COUNTERS
+  // Step counters (created at initialisation)
+  fStepCounters = nullptr;
+#endif
+
+#ifdef G4HepEm_PHASE_TIMERS
+  // Tracking phase timers (created at initialisation)
+  fPhaseTimers = nullptr;
+#endif
+
+  // Batched stepping action (only if the user sets one)
+  fStepBatchAction = nullptr;
+  fStepBatchSize   = 0;
+  fIsFlushStepBatchAtEndOfTrack = false;
+
   fConfig = new G4HepEmConfig;
 
   fVerbose = verbose;
@@ -133,6 +196,16 @@ G4HepEmTrackingManager::~G4HepEmTrackingManager() {
   delete fRunManager;
   delete fRandomEngine;
   delete fStep;
+  delete fHitAggregator;
+  delete fScoringMesh;
+  delete fWDTProfiler;
+  delete fKernelRecorder;
+#ifdef G4HepEm_STEP_COUNTERS
+  delete fStepCounters;
+#endif
+#ifdef G4HepEm_PHASE_TIMERS
+  delete fPhaseTimers;
+#endif
   if (fWDTHelper!=nullptr) {
     delete fWDTHelper;
   }
@@ -141,6 +214,20 @@ G4HepEmTrackingManager::~G4HepEmTrackingManager() {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void G4HepEmTrackingManager::SetStepBatchAction(G4HepEmStepBatchAction* action, std::size_t batchSize, G4bool isFlushAtEndOfTrack) {
+  // deliver what has been recorded with the previous action (if any)
+  FlushStepBatch();
+  fStepBatchAction = action;
+  fStepBatchSize   = batchSize > 0 ? batchSize : 1;
+  fIsFlushStepBatchAtEndOfTrack = isFlushAtEndOfTrack;
+  fStepRecords.clear();
+  if (fStepBatchAction != nullptr) {
+    fStepRecords.reserve(fStepBatchSize);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void G4HepEmTrackingManager::SetVerbose(G4int verbose) {
   fVerbose = verbose;
   if (fRunManager != nullptr) {
@@ -151,13 +238,29 @@ void G4HepEmTrackingManager::SetVerbose(G4int verbose) {
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void G4HepEmTrackingManager::BuildPhysicsTable(const G4ParticleDefinition &part) {
+  // Set the hit aggregation flags per region (same for all particles)
+  InitHitAggregation();
+  // Create the scoring mesh (if requested and not done yet)
+  InitScoringMesh();
+#ifdef G4HepEm_STEP_COUNTERS
+  // Create the step counters (if not done yet)
+  // NOTE: the master counters are constructed first (initialisation of the
+  //       master) and the worker counters will be merged into those.
+  if (fStepCounters == nullptr) {
+    fStepCounters = new G4HepEmStepCounters(G4Threading::IsMasterThread());
+  }
+#endif
   if (&part == G4Electron::Definition()) {
     int particleID = 0;
     fRunManager->Initialize(fRandomEngine, particleID, fConfig->GetG4HepEmParameters());
+    // Set the transparent material-cuts couple flags (HepEm data are available now)
+    InitTransparentMatCuts();
     // Find the electron-nuclear process if has been attached
     InitNuclearProcesses(particleID);
     // Find the fast simulation manager process for e- (if has been attached)
     InitFastSimRelated(particleID);
+    // Find the step limiter and user special cuts processes (if have been attached)
+    InitUserLimitsRelated(particleID);
     // Find the ATLAS specific trans. rad. (XTR) process (if has been attached)
     InitXTRRelated();
     // Report extra process configuration
@@ -167,10 +270,14 @@ void G4HepEmTrackingManager::BuildPhysicsTable(const G4ParticleDefinition &part)
   } else if (&part == G4Positron::Definition()) {
     int particleID = 1;
     fRunManager->Initialize(fRandomEngine, particleID, fConfig->GetG4HepEmParameters());
+    // Set the transparent material-cuts couple flags (HepEm data are available now)
+    InitTransparentMatCuts();
     // Find the positron-nuclear process if has been attached
     InitNuclearProcesses(particleID);
     // Find the fast simulation manager process for e+ (if has been attached)
     InitFastSimRelated(particleID);
+    // Find the step limiter and user special cuts processes (if have been attached)
+    InitUserLimitsRelated(particleID);
     // Report extra process configuration
     if (G4Threading::IsMasterThread() && fVerbose > 0) {
       ReportExtraProcesses(particleID);
@@ -182,10 +289,14 @@ void G4HepEmTrackingManager::BuildPhysicsTable(const G4ParticleDefinition &part)
   } else if (&part == G4Gamma::Definition()) {
     int particleID = 2;
     fRunManager->Initialize(fRandomEngine, particleID, fConfig->GetG4HepEmParameters());
+    // Set the transparent material-cuts couple flags (HepEm data are available now)
+    InitTransparentMatCuts();
     // Find the gamma-nuclear process if has been attached
     InitNuclearProcesses(particleID);
     // Find the fast simulation manager process for gamma (if has been attached)
     InitFastSimRelated(particleID);
+    // Find the step limiter and user special cuts processes (if have been attached)
+    InitUserLimitsRelated(particleID);
     // Init Woodcock tracking data (if any, keep `fWDTHelper` nulltr otherwise)
     std::vector<std::string>& wdtRegionNames = fConfig->GetWoodcockTrackingRegionNames();
     const int numWDTRegion = wdtRegionNames.size();
@@ -195,13 +306,16 @@ void G4HepEmTrackingManager::BuildPhysicsTable(const G4ParticleDefinition &part)
       }
       fWDTHelper = new G4HepEmWoodcockHelper;
       fWDTHelper->SetKineticEnergyLimit(fConfig->GetWDTEnergyLimit());
+      fWDTHelper->SetVoxelSize(fConfig->GetWDTVoxelSize());
       G4VPhysicalVolume* worldVolume = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
-      G4bool hasBeenFound = fWDTHelper->Initialize(wdtRegionNames, fRunManager->GetHepEmData()->fTheMatCutData, worldVolume);
+      G4bool hasBeenFound = fWDTHelper->Initialize(wdtRegionNames, fRunManager->GetHepEmData(), worldVolume);
       if (!hasBeenFound) {
         delete fWDTHelper;
         fWDTHelper = nullptr;
       }
     }
+    // Create the Woodcock tracking profiler (if requested and not done yet)
+    InitWoodcockProfiler();
     // Report extra process configuration
     if (G4Threading::IsMasterThread() && fVerbose > 0) {
       ReportExtraProcesses(particleID);
@@ -212,6 +326,16 @@ void G4HepEmTrackingManager::BuildPhysicsTable(const G4ParticleDefinition &part)
         << std::endl;
     exit(-1);
   }
+  // Create the kernel input recorder (if requested and not done yet)
+  InitKernelRecorder();
+#ifdef G4HepEm_PHASE_TIMERS
+  // Create the tracking phase timers (if not done yet, HepEm data are available now)
+  // NOTE: the master timers are constructed first (initialisation of the master)
+  //       and the worker timers will be merged into those.
+  if (fPhaseTimers == nullptr) {
+    fPhaseTimers = new G4HepEmPhaseTimers(G4Threading::IsMasterThread(), fRunManager->GetHepEmData());
+  }
+#endif
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -229,6 +353,7 @@ void G4HepEmTrackingManager::PreparePhysicsTable(
 
 bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
   TrackingManagerHelper::ChargedNavigation navigation;
+  navigation.SetLeafVolumeShortcut(fConfig->GetLeafVolumeShortcut());
 
   // Prepare for calling the user action.
   auto* evtMgr             = G4EventManager::GetEventManager();
@@ -324,7 +449,9 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
   // Init state that never changes for a track.
   const double charge = aTrack->GetParticleDefinition()->GetPDGCharge();
   const bool isElectron = (charge < 0.0);
+  const int  particleID = isElectron ? 0 : 1;
   thePrimaryTrack->SetCharge(charge);
+  G4HepEmProbe3(track_start, particleID, aTrack->GetTrackID(), G4HepEmProbeEnergy(aTrack->GetKineticEnergy()));
 
   // Invoke the fast simulation manager process StartTracking interface (if any)
   G4VProcess* fFastSimProc = isElectron ? fFastSimProcess[0] : fFastSimProcess[1];
@@ -338,13 +465,18 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
     theNucProcess->StartTracking(aTrack);
   }
 
+  // The region of the previous step (to detect region entry for weight windows)
+  const G4Region* lastRegion = nullptr;
+
   // === StartTracking ===
 
   while(aTrack->GetTrackStatus() == fAlive)
   {
+    G4HepEm_TIMER_START_STEP();
 #ifdef G4HepEm_EARLY_TRACKING_EXIT
     // check for user-defined early exit
     if (CheckEarlyTrackingExit(aTrack, evtMgr, userTrackingAction, secondaries)) {
+      fHitAggregator->Flush();
       return false;
     }
 #endif
@@ -363,6 +495,20 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
     auto* MCC = lvol->GetMaterialCutsCouple();
     preStepPoint.SetMaterialCutsCouple(lvol->GetMaterialCutsCouple());
 
+    // Apply the weight window of the region (if any) when entering the region
+    // (except on the first step of the clones of a split track: these have
+    // already been windowed in this region)
+    const G4Region* region = lvol->GetRegion();
+    if (region != lastRegion) {
+      lastRegion = region;
+      const G4bool isClone = aTrack->GetCurrentStepNumber() == 1 && aTrack->GetCreatorProcess() == fWeightWindowNoProcess;
+      const G4HepEmRegionParmeters& regionPars = theHepEmPars->fParametersPerRegion[region->GetInstanceID()];
+      if (!isClone && regionPars.fWeightWindowLower > 0.0 && !ApplyWeightWindow(aTrack, regionPars, rnge)) {
+        KillTrackInZeroStep(step, fWeightWindowNoProcess, lvol, userSteppingAction, theTrajectory, particleID, false);
+        continue;
+      }
+    }
+
     // Call the fast simulation manager process if any and check if any fast
     // sim models have been triggered (in that case, returns zero proposed
     // step length and `ExclusivelyForced` forced condition i.e. this and only
@@ -385,12 +531,15 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
       if (step.GetControlFlag() != AvoidHitInvocation) {
         auto* sensitive = lvol->GetSensitiveDetector();
         if (sensitive) {
-          sensitive->Hit(&step);
+          fHitAggregator->Invoke(sensitive, step, false);
         }
       }
       if (userSteppingAction) {
         userSteppingAction->UserSteppingAction(&step);
       }
+      if (fStepBatchAction != nullptr) {
+        RecordStep(step, lvol, isElectron ? 0 : 1);
+      }
       auto* regionalAction = lvol->GetRegion()->GetRegionalSteppingAction();
       if (regionalAction) {
         regionalAction->UserSteppingAction(&step);
@@ -411,17 +560,23 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
     const int hepEmIMC =
         theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC];
     thePrimaryTrack->SetMCIndex(hepEmIMC);
+    G4HepEmProbe4(step_begin, particleID, aTrack->GetTrackID(), G4HepEmProbeEnergy(preStepEkin), hepEmIMC);
     bool preStepOnBoundary =
         preStepPoint.GetStepStatus() == G4StepStatus::fGeomBoundary;
     thePrimaryTrack->SetOnBoundary(preStepOnBoundary);
+    // No MSC in transparent (i.e. very low density) material-cuts couples so
+    // the safety is not needed either
+    const bool isTransparent = fIsTransparentMatCut[hepEmIMC];
+    G4HepEm_TIMER_START();
     const double preSafety =
-        preStepOnBoundary ? 0.
+        preStepOnBoundary || isTransparent ? 0.
                    : fSafetyHelper->ComputeSafety(aTrack->GetPosition());
+    G4HepEm_TIMER_STOP(kSafety, hepEmIMC);
     thePrimaryTrack->SetSafety(preSafety);
 
     const int indxRegion  = lvol->GetRegion()->GetInstanceID();
     bool  isApplyCuts = theHepEmPars->fParametersPerRegion[indxRegion].fIsApplyCuts;
-    bool  continueStepping = theHepEmPars->fParametersPerRegion[indxRegion].fIsMultipleStepsInMSCTrans;
+    bool  continueStepping = !isTransparent && theHepEmPars->fParametersPerRegion[indxRegion].fIsMultipleStepsInMSCTrans;
 
     // Sample the `number-of-interaction-left`
     for (int ip=0; ip<4; ++ip) {
@@ -429,8 +584,40 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
         thePrimaryTrack->SetNumIALeft(-G4HepEmLog(rnge->flat()), ip);
       }
     }
+    // Record the kernel input (if requested)
+    if (fKernelRecorder != nullptr) {
+      fKernelRecorder->Record(G4HepEmKernelRecord::kHowFar, particleID, -1, preStepEkin, hepEmIMC,
+                              indxRegion, preSafety, preStepOnBoundary, thePrimaryTrack->GetDirection());
+    }
     // True distance to discrete interaction.
+    G4HepEm_TIMER_START();
     G4HepEmElectronManager::HowFarToDiscreteInteraction(theHepEmData, theHepEmPars, theElTrack);
+    G4HepEm_TIMER_STOP(kHowFar, hepEmIMC);
+    // Apply the `G4UserLimits` of the current volume (if any): the step might
+    // be shortened (no discrete interaction then) or the track might be killed.
+    const G4VProcess* userLimitsProc = nullptr;
+    if (fIsUserLimits[particleID] && fUserLimitsPerLogVol[lvol->GetInstanceID()].fHasUserLimits) {
+      G4bool isKill = false;
+      const G4double userLimitsStep = ComputeUserLimitsStep(lvol->GetInstanceID(), *aTrack, particleID, theElTrack->GetRange(), &userLimitsProc, isKill);
+      if (isKill) {
+        // e+ annihilates at rest as in the normal stopping case (this is why
+        // `G4UserSpecialCuts` uses `fStopButAlive` for e+): the 2 gammas are
+        // stacked (or deposited if below the cut) before killing the track.
+        if (!isElectron) {
+          G4HepEmPositronInteractionAnnihilation::Perform(theTLData, true);
+          step.AddTotalEnergyDeposit(StackSecondaries(theTLData, aTrack, fElectronNoProcessVector[2], g4IMC, isApplyCuts));
+        }
+        KillTrackInZeroStep(step, userLimitsProc, lvol, userSteppingAction, theTrajectory, particleID);
+        continue;
+      }
+      if (userLimitsStep < theElTrack->GetPStepLength()) {
+        theElTrack->SetPStepLength(userLimitsStep);
+        thePrimaryTrack->SetGStepLength(userLimitsStep);
+        thePrimaryTrack->SetWinnerProcessIndex(-1);
+      } else {
+        userLimitsProc = nullptr;
+      }
+    }
     // Remember which process was selected - MSC might limit the sub-steps.
     const int iDProc = thePrimaryTrack->GetWinnerProcessIndex();
 
@@ -441,9 +628,24 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
 
     theElTrack->SavePreStepEKin();
 
+#ifdef G4HepEm_STEP_COUNTERS
+    int numMSCSubSteps = 0;
+#endif
     do {
+#ifdef G4HepEm_STEP_COUNTERS
+      ++numMSCSubSteps;
+#endif
       // Possibly true step limit of MSC, and conversion to geometrical step length.
-      G4HepEmElectronManager::HowFarToMSC(theHepEmData, theHepEmPars, theElTrack, rnge);
+      // (straight to the navigation without MSC in transparent couples)
+      if (isTransparent) {
+        G4HepEmMSCTrackData* mscData = theElTrack->GetMSCTrackData();
+        mscData->fIsActive = false;
+        mscData->SetDisplacement(0., 0., 0.);
+      } else {
+        G4HepEm_TIMER_START();
+        G4HepEmElectronManager::HowFarToMSC(theHepEmData, theHepEmPars, theElTrack, rnge);
+        G4HepEm_TIMER_STOP(kHowFar, hepEmIMC);
+      }
       if (thePrimaryTrack->GetWinnerProcessIndex() != -2) {
         // If MSC did not limit the step, exit the loop after this iteration.
         continueStepping = false;
@@ -452,6 +654,7 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
       // Get the geometrcal step length: straight line distance to make along the
       // original direction.
       G4double physicalStep = thePrimaryTrack->GetGStepLength();
+      G4HepEm_TIMER_START();
       G4double geometryStep = navigation.MakeStep(*aTrack, step, physicalStep);
 
       bool geometryLimitedStep = geometryStep < physicalStep;
@@ -460,6 +663,7 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
       step.UpdateTrack();
 
       navigation.FinishStep(*aTrack, step);
+      G4HepEm_TIMER_STOP(kNavigation, hepEmIMC);
 
       if (geometryLimitedStep) {
         continueStepping = false;
@@ -485,6 +689,7 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
       // invoke the physics interactions (all i.e. all along- and post-step as
       // well as possible at rest)
 
+      G4HepEm_TIMER_START();
       if (finalStep > 0) {
         do {
           //
@@ -536,8 +741,13 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
               // apply displacement
               bool isPositionChanged = true;
               const double dispR = std::sqrt(dLength2);
+              // the geometry calls are not part of the continuous phase
+              G4HepEm_TIMER_STOP(kContinuous, hepEmIMC);
+              G4HepEm_TIMER_START();
               const double postSafety =
                   0.99 * fSafetyHelper->ComputeSafety(position, dispR);
+              G4HepEm_TIMER_STOP(kSafety, hepEmIMC);
+              G4HepEm_TIMER_START();
               const G4ThreeVector theDisplacement(displacement[0], displacement[1],
                                                   displacement[2]);
               // far away from geometry boundary
@@ -557,7 +767,11 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
                 }
               }
               if (isPositionChanged) {
+                G4HepEm_TIMER_STOP(kContinuous, hepEmIMC);
+                G4HepEm_TIMER_START();
                 fSafetyHelper->ReLocateWithinVolume(position);
+                G4HepEm_TIMER_STOP(kNavigation, hepEmIMC);
+                G4HepEm_TIMER_START();
                 postStepPoint.SetPosition(position);
               }
             }
@@ -590,6 +804,7 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
         }
 
       }
+      G4HepEm_TIMER_STOP(kContinuous, hepEmIMC);
     } while (continueStepping);
 
     // Restore the total (mean) energy loss accumulated along the sub-steps.
@@ -599,7 +814,9 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
       // If not already stopped, restore the pre-step energy and sample loss
       // fluctuations.
       theElTrack->SetPreStepEKin(preStepEkin, preStepLogEkin);
+      G4HepEm_TIMER_START();
       stopped = G4HepEmElectronManager::SampleLossFluctuations(theHepEmData, theHepEmPars, theElTrack, rnge);
+      G4HepEm_TIMER_STOP(kContinuous, hepEmIMC);
     }
 
     // ATLAS XTR RELATED:
@@ -628,13 +845,30 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
         proc = fTransportNoProcess;
       } else if (iDProc != 3) {
         // interactions handled by the HepEm physics: ioni, brem or annihilation (for e+)
+        // (or no interaction at all when the step was limited by the continuous
+        // part or the user limits, i.e. -1, or by MSC, i.e. -2)
+        if (iDProc >= 0) {
+          G4HepEmProbe4(interaction, particleID, iDProc, G4HepEmProbeEnergy(thePrimaryTrack->GetEKin()), hepEmIMC);
+          if (fKernelRecorder != nullptr) {
+            fKernelRecorder->Record(G4HepEmKernelRecord::kPerform, particleID, iDProc, thePrimaryTrack->GetEKin(),
+                                    hepEmIMC, indxRegion, 0.0, false, thePrimaryTrack->GetDirection());
+          }
+        }
+        G4HepEm_TIMER_START();
         G4HepEmElectronManager::PerformDiscrete(theHepEmData, theHepEmPars, theTLData);
+        G4HepEm_TIMER_STOP(kDiscrete, hepEmIMC);
+        // the weight of the primary might have been changed by the leading
+        // particle biasing (the HepEm track weight is the factor of the change)
+        if (thePrimaryTrack->GetWeight() != 1.0) {
+          postStepPoint.SetWeight(postStepPoint.GetWeight()*thePrimaryTrack->GetWeight());
+          thePrimaryTrack->SetWeight(1.0);
+        }
         const double *pdir = thePrimaryTrack->GetDirection();
         postStepPoint.SetMomentumDirection( G4ThreeVector(pdir[0], pdir[1], pdir[2]) );
         // Get the final process defining the step - might still be MSC!
         if (iDProc == -1) {
-          // ionization
-          proc = fElectronNoProcessVector[0];
+          // ionization (or the user limits if they limited the step)
+          proc = userLimitsProc != nullptr ? userLimitsProc : fElectronNoProcessVector[0];
         } else if (iDProc == -2) {
           proc = fElectronNoProcessVector[3];
         } else {
@@ -648,6 +882,7 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
         // Invoke the electron/positron-nuclear interaction using the Geant4 process
         G4VParticleChange* particleChangeNuc = nullptr;
         if (theNucProcess != nullptr && !G4HepEmElectronManager::CheckDelta(theHepEmData, thePrimaryTrack, theTLData->GetRNGEngine()->flat())) {
+          G4HepEmProbe4(interaction, particleID, iDProc, G4HepEmProbeEnergy(thePrimaryTrack->GetEKin()), hepEmIMC);
           // call to set some fields of the process like material, energy etc.. used in its DoIt
           G4ForceCondition forceCondition;
           theNucProcess->PostStepGetPhysicalInteractionLength(*aTrack, 0.0, &forceCondition);
@@ -698,6 +933,17 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
 
     postStepPoint.SetProcessDefinedStep(proc);
 
+#ifdef G4HepEm_STEP_COUNTERS
+    {
+      // e+ annihilates at rest when stopped while otherwise, a discrete
+      // interaction happened if a discrete process was selected (not on boundary)
+      const bool isInteraction = stopped ? !isElectron
+                                 : (proc != fTransportNoProcess && thePrimaryTrack->GetWinnerProcessIndex() >= 0);
+      fStepCounters->CountStep(indxRegion, particleID, GetStepCounterSlot(proc, particleID),
+                               isInteraction, totalTruePathLength, numMSCSubSteps);
+    }
+#endif
+
     // energy, e-depo and status
     const double ekin = thePrimaryTrack->GetEKin();
     double edep = thePrimaryTrack->GetEnergyDeposit();
@@ -708,7 +954,9 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
     step.UpdateTrack();
 
     // Stack secondaries created by the HepEm physics above
+    G4HepEm_TIMER_START();
     edep += StackSecondaries(theTLData, aTrack, proc, g4IMC, isApplyCuts);
+    G4HepEm_TIMER_STOP(kStacking, hepEmIMC);
 
     // ATLAS XTR RELATED:
     // Stack XTR secondaries (if any)
@@ -732,16 +980,26 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
 
     step.AddTotalEnergyDeposit(edep);
 
+    // Fill the built-in scoring mesh (if any) at the mid-point of the step.
+    // NOTE: the deposit belongs to the pre-step weight (the post-step, i.e. the
+    //       track, weight might have been changed by leading particle biasing)
+    if (fScoringMesh != nullptr && step.GetTotalEnergyDeposit() > 0.0) {
+      const G4ThreeVector midPoint = 0.5*(preStepPoint.GetPosition() + postStepPoint.GetPosition());
+      fScoringMesh->Fill(midPoint.x(), midPoint.y(), midPoint.z(), step.GetTotalEnergyDeposit()*preStepPoint.GetWeight());
+    }
+
     // Need to get the true step length, not the geometry step length!
     aTrack->AddTrackLength(step.GetStepLength());
 
     // End of this step: Call sensitive detector and stepping actions.
+    // (the step might be aggregated with the next ones in the same touchable)
+    G4HepEm_TIMER_START();
     if(step.GetControlFlag() != AvoidHitInvocation)
     {
       auto* sensitive = lvol->GetSensitiveDetector();
       if(sensitive)
       {
-        sensitive->Hit(&step);
+        fHitAggregator->Invoke(sensitive, step, fIsHitAggregation && fIsHitAggregationRegion[indxRegion]);
       }
     }
 
@@ -750,11 +1008,19 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
       userSteppingAction->UserSteppingAction(&step);
     }
 
+    if(fStepBatchAction != nullptr)
+    {
+      RecordStep(step, lvol, isElectron ? 0 : 1);
+    }
+
     auto* regionalAction = lvol->GetRegion()->GetRegionalSteppingAction();
     if(regionalAction)
     {
       regionalAction->UserSteppingAction(&step);
     }
+    G4HepEm_TIMER_STOP(kUserActions, hepEmIMC);
+    G4HepEmProbe4(step_end, particleID, aTrack->GetTrackID(), G4HepEmProbeLength(step.GetStepLength()),
+                  G4HepEmProbeEnergy(step.GetTotalEnergyDeposit()));
 
     // Append the trajectory if it was requested.
     if (theTrajectory != nullptr) {
@@ -765,11 +1031,21 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
   // End of tracking: Inform processes and user.
   // === EndTracking ===
 
+  // Hand over the pending aggregated step (if any) to its SD
+  fHitAggregator->Flush();
+
+  // Deliver the step records to the batched stepping action if requested
+  if (fIsFlushStepBatchAtEndOfTrack) {
+    FlushStepBatch();
+  }
+
   // Invoke the fast simulation manager process EndTracking interface (if any)
   if (fFastSimProc != nullptr) {
     fFastSimProc->EndTracking();
   }
 
+  G4HepEmProbe3(track_end, particleID, aTrack->GetTrackID(), aTrack->GetCurrentStepNumber());
+
   if(userTrackingAction)
   {
     userTrackingAction->PostUserTrackingAction(aTrack);
@@ -788,6 +1064,7 @@ bool G4HepEmTrackingManager::TrackElectron(G4Track *aTrack) {
 
 bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
   TrackingManagerHelper::NeutralNavigation navigation;
+  navigation.SetLeafVolumeShortcut(fConfig->GetLeafVolumeShortcut());
 
   // Prepare for calling the user action.
   auto* evtMgr             = G4EventManager::GetEventManager();
@@ -872,6 +1149,10 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
   // number as long as we are in the same event, but play it safe.
   G4HepEmRandomEngine *rnge = theTLData->GetRNGEngine();
   rnge->DiscardGauss();
+  // Same for the random numbers buffered in the Woodcock tracking helper.
+  if (fWDTHelper != nullptr) {
+    fWDTHelper->DiscardRandoms();
+  }
 
   // Pull data structures into local variables.
   G4HepEmData *theHepEmData = fRunManager->GetHepEmData();
@@ -880,6 +1161,7 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
   const G4DynamicParticle *theG4DPart = aTrack->GetDynamicParticle();
 
   thePrimaryTrack->SetCharge(0);
+  G4HepEmProbe3(track_start, 2, aTrack->GetTrackID(), G4HepEmProbeEnergy(aTrack->GetKineticEnergy()));
 
   // Invoke the fast simulation manager process StartTracking interface (if any)
   G4VProcess* fFastSimProc = fFastSimProcess[2];
@@ -893,12 +1175,16 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
 
   // Reset some Woodcock tracking related flags.
   G4bool isWDTOn = false;
+  // The region of the previous step (to detect region entry for weight windows)
+  const G4Region* lastRegion = nullptr;
   // === StartTracking ===
 
   while (aTrack->GetTrackStatus() == fAlive) {
+    G4HepEm_TIMER_START_STEP();
 #ifdef G4HepEm_EARLY_TRACKING_EXIT
     // check for user-defined early exit
     if (CheckEarlyTrackingExit(aTrack, evtMgr, userTrackingAction, secondaries)) {
+      fHitAggregator->Flush();
       return false;
     }
 #endif
@@ -916,6 +1202,20 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
     auto* MCC = lvol->GetMaterialCutsCouple();
     preStepPoint.SetMaterialCutsCouple(lvol->GetMaterialCutsCouple());
 
+    // Apply the weight window of the region (if any) when entering the region
+    // (except on the first step of the clones of a split track: these have
+    // already been windowed in this region)
+    const G4Region* region = lvol->GetRegion();
+    if (region != lastRegion) {
+      lastRegion = region;
+      const G4bool isClone = aTrack->GetCurrentStepNumber() == 1 && aTrack->GetCreatorProcess() == fWeightWindowNoProcess;
+      const G4HepEmRegionParmeters& regionPars = theHepEmPars->fParametersPerRegion[region->GetInstanceID()];
+      if (!isClone && regionPars.fWeightWindowLower > 0.0 && !ApplyWeightWindow(aTrack, regionPars, rnge)) {
+        KillTrackInZeroStep(step, fWeightWindowNoProcess, lvol, userSteppingAction, theTrajectory, 2, false);
+        continue;
+      }
+    }
+
     // Call the fast simulation manager process if any and check if any fast
     // sim models have been triggered (in that case, returns zero proposed
     // step length and `ExclusivelyForced` forced condition i.e. this and only
@@ -938,12 +1238,15 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
       if (step.GetControlFlag() != AvoidHitInvocation) {
         auto* sensitive = lvol->GetSensitiveDetector();
         if (sensitive) {
-          sensitive->Hit(&step);
+          fHitAggregator->Invoke(sensitive, step, false);
         }
       }
       if (userSteppingAction) {
         userSteppingAction->UserSteppingAction(&step);
       }
+      if (fStepBatchAction != nullptr) {
+        RecordStep(step, lvol, 2);
+      }
       auto* regionalAction = lvol->GetRegion()->GetRegionalSteppingAction();
       if (regionalAction) {
         regionalAction->UserSteppingAction(&step);
@@ -955,6 +1258,14 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
       continue;
     }
 
+    // Kill the gamma, depositing its energy, if it's below the tracking cut of
+    // the region (local absorption, i.e. as photoelectric effect)
+    const G4double gammaTrackingCut = theHepEmPars->fParametersPerRegion[lvol->GetRegion()->GetInstanceID()].fGammaTrackingCut;
+    if (aTrack->GetKineticEnergy() <= gammaTrackingCut) {
+      KillTrackInZeroStep(step, fGammaNoProcessVector[2], lvol, userSteppingAction, theTrajectory, 2);
+      continue;
+    }
+
     // If any Woodcock tracking region was found at initialization and the gamma
     // is not already under Woodcock tracking, then check:
     // - this step will be done in one of the Woodcock tracking regions with
@@ -962,7 +1273,7 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
     // Then find in which root volume of the region this step will be done, and:
     // - obtain the actual physical volume transformation (will be used when
     //   calculating distance to out of the WDT envelop volume
-    // - set the WDT solid, G4 couple  and its HepEm index of the helper accordingly
+    // - set the WDT solid and the majorant cross section table of the helper accordingly
     // NOTE: as long as the actual WWDT envelop volume boundary is not reached,
     //       all these above data stay the same (so no need to redo this till
     //       WDT doesn't reach its boundary; when `isWDTOn` is set to `false`)
@@ -974,6 +1285,20 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
     // (NOTE: `isWDTOn` can be `true` only if `fWDTHelper != nulltr`!)
     isWDTOn = isWDTOn && (aTrack->GetKineticEnergy() > fWDTHelper->GetKineticEnergyLimit());
 
+    // Apply the `G4UserLimits` of the current volume (if any) but only in normal,
+    // i.e. NOT Woodcock tracking steps: the track might be killed here or the
+    // step limit is stored to be used below.
+    const G4VProcess* userLimitsProc = nullptr;
+    G4double userLimitsStep = DBL_MAX;
+    if (!isWDTOn && fIsUserLimits[2] && fUserLimitsPerLogVol[lvol->GetInstanceID()].fHasUserLimits) {
+      G4bool isKill = false;
+      userLimitsStep = ComputeUserLimitsStep(lvol->GetInstanceID(), *aTrack, 2, DBL_MAX, &userLimitsProc, isKill);
+      if (isKill) {
+        KillTrackInZeroStep(step, userLimitsProc, lvol, userSteppingAction, theTrajectory, 2);
+        continue;
+      }
+    }
+
     // Prepare some HepEmTrack fileds needed both for normal and WDT cases.
     const G4double preStepEkin    = theG4DPart->GetKineticEnergy();
     const G4double preStepLogEkin = theG4DPart->GetLogKineticEnergy();
@@ -982,6 +1307,8 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
     thePrimaryTrack->SetDirection(primDir[0], primDir[1], primDir[2]);
 
     int g4IMC = MCC->GetIndex();
+    G4HepEmProbe4(step_begin, 2, aTrack->GetTrackID(), G4HepEmProbeEnergy(preStepEkin),
+                  theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
 
     // Init the value of the physical step length and the flag to indicate if
     // number of interaction length left should be updated in case of boundary
@@ -999,9 +1326,24 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
       // Query step lengths from pyhsics
       const int hepEmIMC = theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC];
       thePrimaryTrack->SetMCIndex(hepEmIMC);
+      // Record the kernel input (if requested)
+      if (fKernelRecorder != nullptr) {
+        fKernelRecorder->Record(G4HepEmKernelRecord::kHowFar, 2, -1, preStepEkin, hepEmIMC,
+                                lvol->GetRegion()->GetInstanceID(), 0.0,
+                                preStepPoint.GetStepStatus() == G4StepStatus::fGeomBoundary,
+                                thePrimaryTrack->GetDirection());
+      }
 
+      G4HepEm_TIMER_START();
       G4HepEmGammaManager::HowFar(theHepEmData, theHepEmPars, theTLData);
+      G4HepEm_TIMER_STOP(kHowFar, hepEmIMC);
       physicalStep = thePrimaryTrack->GetGStepLength();
+      // The user limits might give a shorter step (no interaction then)
+      if (userLimitsStep < physicalStep) {
+        physicalStep = userLimitsStep;
+      } else {
+        userLimitsProc = nullptr;
+      }
     } else {
       // Keep "Woodock" tracking of the gamma till either it gets to a point
       // where physics interaction happens or gets close to the boundary of the
@@ -1009,8 +1351,13 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
       // to be the same as the post-step point one (as we might cross multiple
       // volume boundaries).
       // (NOTE: `isWDTOn` can be `true` only if `fWDTHelper != nulltr`!)
-      isWDTReachedBoundary = fWDTHelper->KeepTracking(theHepEmData, theGammaTrack, *aTrack);
+      // (the Woodcock tracking is attributed to the navigation)
+      G4HepEm_TIMER_START();
+      isWDTReachedBoundary = fWDTHelper->KeepTracking(theHepEmData, theGammaTrack, *aTrack, rnge);
+      G4HepEm_TIMER_STOP(kNavigation, theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
       wdtStepLength = thePrimaryTrack->GetGStepLength();
+      // the touchable might have been replaced by the Woodcock tracking
+      navigation.InvalidateLeafVolume();
 
       // Set the logical volume and g4 couple used later ()
       lvol = aTrack->GetTouchable()->GetVolume()->GetLogicalVolume();
@@ -1033,7 +1380,9 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
     }
 
     // Query step lengths from geometry, decide on limit.
+    G4HepEm_TIMER_START();
     G4double geometryStep = navigation.MakeStep(*aTrack, step, physicalStep);
+    G4HepEm_TIMER_STOP(kNavigation, theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
 
     bool geometryLimitedStep = geometryStep < physicalStep;
     G4double finalStep = geometryLimitedStep ? geometryStep : physicalStep;
@@ -1066,6 +1415,13 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
       thePrimaryTrack->SetGStepLength(finalStep);
     }
 
+    // Record the normal (non-WDT) steps in the Woodcock tracking profiling mode
+    // (the pre-step touchable is still the one of the track)
+    if (fWDTProfiler != nullptr && updateNumIALeft) {
+      const G4double mfp = thePrimaryTrack->GetMFP(0);
+      fWDTProfiler->RecordStep(*aTrack, preStepEkin, mfp > 0.0 ? 1.0/mfp : 0.0, finalStep, geometryLimitedStep);
+    }
+
     // The track and the step always have the total, i.e. WDT plus normal (if any)
     // step lengths but `thePrimaryTrack` has only the normal one or zero (see above).
     step.SetStepLength(finalStep+wdtStepLength);
@@ -1073,7 +1429,9 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
 
     step.UpdateTrack();
 
+    G4HepEm_TIMER_START();
     navigation.FinishStep(*aTrack, step);
+    G4HepEm_TIMER_STOP(kNavigation, theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
 
     // Check if the track left the world.
     if (aTrack->GetNextVolume() == nullptr) {
@@ -1093,6 +1451,11 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
         if (updateNumIALeft) {
           G4HepEmGammaManager::UpdateNumIALeft(thePrimaryTrack);
         }
+      } else if (userLimitsProc != nullptr) {
+        // The user limits limited the step: no interaction only the number of
+        // interaction length left needs to be updated (as on boundary)
+        proc = userLimitsProc;
+        G4HepEmGammaManager::UpdateNumIALeft(thePrimaryTrack);
       } else {
         double edep = 0.0;
         // Get the region index
@@ -1107,7 +1470,22 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
         if (iDProc != 3) {
           // Conversion, Compton or photoelectric --> use HepEm for the interaction
           // (NOTE: Ekin, MC-index, step-length, onBoundary have all set)
+          G4HepEmProbe4(interaction, 2, iDProc, G4HepEmProbeEnergy(thePrimaryTrack->GetEKin()),
+                        theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
+          if (fKernelRecorder != nullptr) {
+            fKernelRecorder->Record(G4HepEmKernelRecord::kPerform, 2, iDProc, thePrimaryTrack->GetEKin(),
+                                    theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC],
+                                    indxRegion, 0.0, false, thePrimaryTrack->GetDirection());
+          }
+          G4HepEm_TIMER_START();
           G4HepEmGammaManager::Perform(theHepEmData, theHepEmPars, theTLData);
+          G4HepEm_TIMER_STOP(kDiscrete, theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
+          // the weight of the primary might have been changed by the leading
+          // particle biasing (the HepEm track weight is the factor of the change)
+          if (thePrimaryTrack->GetWeight() != 1.0) {
+            postStepPoint.SetWeight(postStepPoint.GetWeight()*thePrimaryTrack->GetWeight());
+            thePrimaryTrack->SetWeight(1.0);
+          }
           // energy, e-depo, momentum direction and status
           const double ekin = thePrimaryTrack->GetEKin();
           edep = thePrimaryTrack->GetEnergyDeposit();
@@ -1121,7 +1499,9 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
           step.UpdateTrack();
 
           // Stack secondaries created by the HepEm physics above
+          G4HepEm_TIMER_START();
           edep += StackSecondaries(theTLData, aTrack, fGammaNoProcessVector[iDProc], g4IMC, isApplyCuts);
+          G4HepEm_TIMER_STOP(kStacking, theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
 
         } else {
           // Gamma-nuclear: --> use Geant4 for the interaction:
@@ -1131,6 +1511,8 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
           // Invoke the gamma-nuclear interaction using the Geant4 process
           G4VParticleChange* particleChangeGNuc = nullptr;
           if (fGNucProcess != nullptr) {
+            G4HepEmProbe4(interaction, 2, iDProc, G4HepEmProbeEnergy(thePrimaryTrack->GetEKin()),
+                          theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
             // call to set some fields of the process like material, energy etc...
             G4ForceCondition forceCondition;
             fGNucProcess->PostStepGetPhysicalInteractionLength(*aTrack, 0.0, &forceCondition);
@@ -1153,28 +1535,51 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
         // Set process defined setp and add edep to the step
         proc = fGammaNoProcessVector[iDProc];
         step.AddTotalEnergyDeposit(edep);
+        // Fill the built-in scoring mesh (if any) at the interaction point
+        // (with the pre-step weight, see above at the e-/e+)
+        if (fScoringMesh != nullptr && edep > 0.0) {
+          const G4ThreeVector& postPoint = postStepPoint.GetPosition();
+          fScoringMesh->Fill(postPoint.x(), postPoint.y(), postPoint.z(), edep*step.GetPreStepPoint()->GetWeight());
+        }
         // END if NOT onBoundary
       }
 
       postStepPoint.SetProcessDefinedStep(proc);
+#ifdef G4HepEm_STEP_COUNTERS
+      {
+        // an interaction happened if one of the HepEm processes limited the step
+        const int slot = GetStepCounterSlot(proc, 2);
+        fStepCounters->CountStep(lvol->GetRegion()->GetInstanceID(), 2, slot, slot > 1,
+                                 step.GetStepLength(), 0);
+      }
+#endif
     } // END status is NOT fStopAndKill
 
     aTrack->AddTrackLength(step.GetStepLength());
 
     // End of this step: Call sensitive detector and stepping actions.
+    // (the step might be aggregated with the next ones in the same touchable)
+    G4HepEm_TIMER_START();
     if(step.GetControlFlag() != AvoidHitInvocation) {
       auto* sensitive = lvol->GetSensitiveDetector();
       if(sensitive) {
-        sensitive->Hit(&step);
+        const G4bool isAggregate = fIsHitAggregation && fIsHitAggregationRegion[lvol->GetRegion()->GetInstanceID()];
+        fHitAggregator->Invoke(sensitive, step, isAggregate);
       }
     }
     if(userSteppingAction) {
       userSteppingAction->UserSteppingAction(&step);
     }
+    if(fStepBatchAction != nullptr) {
+      RecordStep(step, lvol, 2);
+    }
     auto* regionalAction = lvol->GetRegion()->GetRegionalSteppingAction();
     if(regionalAction) {
       regionalAction->UserSteppingAction(&step);
     }
+    G4HepEm_TIMER_STOP(kUserActions, theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[g4IMC]);
+    G4HepEmProbe4(step_end, 2, aTrack->GetTrackID(), G4HepEmProbeLength(step.GetStepLength()),
+                  G4HepEmProbeEnergy(step.GetTotalEnergyDeposit()));
     // Append the trajectory if a trajectory was set by the user.
     if (theTrajectory != nullptr) {
       theTrajectory->AppendStep(&step);
@@ -1185,11 +1590,21 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
   // End of tracking: Inform processes and user.
   // === EndTracking ===
 
+  // Hand over the pending aggregated step (if any) to its SD
+  fHitAggregator->Flush();
+
+  // Deliver the step records to the batched stepping action if requested
+  if (fIsFlushStepBatchAtEndOfTrack) {
+    FlushStepBatch();
+  }
+
   // Invoke the fast simulation manager process EndTracking interface (if any)
   if (fFastSimProc != nullptr) {
     fFastSimProc->EndTracking();
   }
 
+  G4HepEmProbe3(track_end, 2, aTrack->GetTrackID(), aTrack->GetCurrentStepNumber());
+
   if(userTrackingAction)
   {
     userTrackingAction->PostUserTrackingAction(aTrack);
@@ -1206,6 +1621,33 @@ bool G4HepEmTrackingManager::TrackGamma(G4Track *aTrack) {
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void G4HepEmTrackingManager::FlushEvent() {
+  // Lock-free merge of the energy deposits of this event into the master mesh
+  if (fScoringMesh != nullptr) {
+    fScoringMesh->Merge();
+  }
+  // Same for the Woodcock tracking profiler statistics
+  if (fWDTProfiler != nullptr) {
+    fWDTProfiler->Merge();
+  }
+  // Write the kernel input records of this event
+  if (fKernelRecorder != nullptr) {
+    fKernelRecorder->Flush();
+  }
+#ifdef G4HepEm_STEP_COUNTERS
+  // Same for the step counters
+  fStepCounters->Merge();
+#endif
+#ifdef G4HepEm_PHASE_TIMERS
+  // Same for the tracking phase timers
+  fPhaseTimers->Merge();
+#endif
+  // Deliver the remaining step records of this event (if any)
+  FlushStepBatch();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void G4HepEmTrackingManager::HandOverOneTrack(G4Track *aTrack) {
   const G4ParticleDefinition *part = aTrack->GetParticleDefinition();
 
@@ -1220,6 +1662,147 @@ void G4HepEmTrackingManager::HandOverOneTrack(G4Track *aTrack) {
 }
 
 
+void G4HepEmTrackingManager::InitHitAggregation() {
+  const int numRegions = G4RegionStore::GetInstance()->size();
+  fIsHitAggregationRegion.assign(numRegions, false);
+  fIsHitAggregation = false;
+  for (const std::string& regionName : fConfig->GetHitAggregationRegionNames()) {
+    G4Region* region = G4RegionStore::GetInstance()->GetRegion(regionName, false);
+    if (region == nullptr) {
+      std::cerr << " *** WARNING in G4HepEmTrackingManager::InitHitAggregation:\n"
+                << "     Unknown detector region with name = " << regionName
+                << " (hit aggregation was not activated there)."
+                << std::endl;
+      continue;
+    }
+    fIsHitAggregationRegion[region->GetInstanceID()] = true;
+    fIsHitAggregation = true;
+  }
+}
+
+
+void G4HepEmTrackingManager::InitTransparentMatCuts() {
+  const G4HepEmData* theHepEmData = fRunManager->GetHepEmData();
+  const int numMatCuts = theHepEmData->fTheMatCutData->fNumMatCutData;
+  fIsTransparentMatCut.assign(numMatCuts, false);
+  const G4double densityThreshold = fConfig->GetTransparentDensityThreshold();
+  if (densityThreshold <= 0.0) {
+    return;
+  }
+  for (int imc=0; imc<numMatCuts; ++imc) {
+    const int imat = theHepEmData->fTheMatCutData->fMatCutData[imc].fHepEmMatIndex;
+    fIsTransparentMatCut[imc] = theHepEmData->fTheMaterialData->fMaterialData[imat].fDensity < densityThreshold;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4HepEmTrackingManager::InitScoringMesh() {
+  const G4int meshType = fConfig->GetScoringMeshType();
+  if (fScoringMesh != nullptr || meshType < 0) {
+    return;
+  }
+  // NOTE: the master mesh is constructed first (initialisation of the master)
+  //       and the worker meshes will merge their deposits into that one.
+  fScoringMesh = new G4HepEmScoringMesh(G4Threading::IsMasterThread(),
+                                        static_cast<G4HepEmScoringMesh::MeshType>(meshType),
+                                        fConfig->GetScoringMeshNumBins(),
+                                        fConfig->GetScoringMeshMin(),
+                                        fConfig->GetScoringMeshMax());
+}
+
+
+#ifdef G4HepEm_STEP_COUNTERS
+int G4HepEmTrackingManager::GetStepCounterSlot(const G4VProcess* proc, int particleID) const {
+  if (proc == fTransportNoProcess) {
+    return 0;
+  }
+  const std::vector<G4HepEmNoProcess*>& procs = particleID < 2 ? fElectronNoProcessVector : fGammaNoProcessVector;
+  for (std::size_t ip=0; ip<procs.size(); ++ip) {
+    if (proc == procs[ip]) {
+      return 2 + ip;
+    }
+  }
+  return 1;
+}
+
+
+int G4HepEmTrackingManager::GetStepCounterParticleID(const G4Track* track) const {
+  const G4ParticleDefinition* part = track->GetParticleDefinition();
+  return part == G4Gamma::Definition() ? 2 : (part == G4Positron::Definition() ? 1 : 0);
+}
+
+
+#endif
+void G4HepEmTrackingManager::InitWoodcockProfiler() {
+  if (fWDTProfiler != nullptr || !fConfig->GetWDTProfiling()) {
+    return;
+  }
+  // NOTE: the master profiler is constructed first (initialisation of the master)
+  //       and the worker profilers will merge their statistics into that one.
+  fWDTProfiler = new G4HepEmWoodcockProfiler(G4Threading::IsMasterThread(),
+                                             fRunManager->GetHepEmData(),
+                                             fConfig->GetWDTEnergyLimit());
+}
+
+
+void G4HepEmTrackingManager::InitKernelRecorder() {
+  const std::string& fileName = fConfig->GetKernelRecordFileName();
+  if (fileName.empty()) {
+    return;
+  }
+  // The state is written (once) by the master when the data of all the 3
+  // particles are available.
+  const G4HepEmData* hepEmData = fRunManager->GetHepEmData();
+  if (G4Threading::IsMasterThread() && !fIsKernelStateWritten && hepEmData->fTheElectronData != nullptr
+      && hepEmData->fThePositronData != nullptr && hepEmData->fTheGammaData != nullptr) {
+    const std::string stateFileName = fileName + ".state.json";
+    if (!G4HepEmKernelRecorder::WriteState(stateFileName, fRunManager->GetHepEmData(), fConfig->GetG4HepEmParameters())) {
+      std::cerr << " *** ERROR in G4HepEmTrackingManager::InitKernelRecorder: "
+                << "cannot write the HepEm state into " << stateFileName << std::endl;
+      exit(-1);
+    }
+    fIsKernelStateWritten = true;
+  }
+  // The records are written by the workers (or the master of a sequential application).
+  if (fKernelRecorder != nullptr || (G4Threading::IsMasterThread() && G4Threading::IsMultithreadedApplication())) {
+    return;
+  }
+  const G4int threadID = std::max(0, G4Threading::G4GetThreadId());
+  fKernelRecorder = new G4HepEmKernelRecorder(fileName + ".t" + std::to_string(threadID) + ".bin",
+                                              fConfig->GetKernelRecordDirection());
+}
+
+
+void G4HepEmTrackingManager::RecordStep(const G4Step& step, const G4LogicalVolume* lvol, int particleID) {
+  const G4Track* track = step.GetTrack();
+  const G4ThreeVector& pos = step.GetPostStepPoint()->GetPosition();
+  fStepRecords.emplace_back();
+  G4HepEmStepRecord& rec = fStepRecords.back();
+  rec.fPosition[0] = pos.x();
+  rec.fPosition[1] = pos.y();
+  rec.fPosition[2] = pos.z();
+  rec.fEDep        = step.GetTotalEnergyDeposit();
+  rec.fStepLength  = step.GetStepLength();
+  rec.fWeight      = track->GetWeight();
+  rec.fTrackID     = track->GetTrackID();
+  rec.fVolumeID    = lvol->GetInstanceID();
+  rec.fParticleID  = particleID;
+  if (fStepRecords.size() >= fStepBatchSize) {
+    FlushStepBatch();
+  }
+}
+
+
+void G4HepEmTrackingManager::FlushStepBatch() {
+  if (fStepBatchAction == nullptr || fStepRecords.empty()) {
+    return;
+  }
+  fStepBatchAction->ProcessSteps(fStepRecords.data(), fStepRecords.size());
+  fStepRecords.clear();
+}
+
+
 // Helper that can be used to stack secondary e-/e+ and gamma i.e. everything
 // that HepEm physics can produce
 double G4HepEmTrackingManager::StackSecondaries(G4HepEmTLData* aTLData, G4Track* aG4PrimaryTrack, const G4VProcess* aG4CreatorProcess, int aG4IMC, bool isApplyCuts) {
@@ -1239,21 +1822,52 @@ double G4HepEmTrackingManager::StackSecondaries(G4HepEmTLData* aTLData, G4Track*
   const G4ThreeVector&     theG4PostStepPointPosition = postStepPoint.GetPosition();
   const G4double           theG4PostStepGlobalTime    = postStepPoint.GetGlobalTime();
   const G4TouchableHandle& theG4TouchableHandle       = aG4PrimaryTrack->GetTouchableHandle();
-  const double             theG4ParentTrackWeight     = aG4PrimaryTrack->GetWeight();
+  // NOTE: the weight before the interaction as the primary weight might have
+  //       been changed already by the leading particle biasing
+  const double             theG4ParentTrackWeight     = step.GetPreStepPoint()->GetWeight();
   const int                theG4ParentTrackID         = aG4PrimaryTrack->GetTrackID();
 
+  // The e- and gamma tracking cuts of the region (e+ would annihilate so not cut)
+  const G4HepEmData*       theHepEmData = fRunManager->GetHepEmData();
+  const int                theHepEmIMC  = theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[aG4IMC];
+  const int                theIRegion   = theHepEmData->fTheMatCutData->fMatCutData[theHepEmIMC].fG4RegionIndex;
+  const G4HepEmRegionParmeters& theRegionPars = fRunManager->GetHepEmParameters()->fParametersPerRegion[theIRegion];
+  // Secondary e- are deposited below the regional tracking cut only if it was
+  // raised above the global one (i.e. the default behaviour is unchanged).
+  const bool isElectronTrackingCut = theRegionPars.fElectronTrackingCut > fRunManager->GetHepEmParameters()->fElectronTrackingCut;
+
+#if defined(G4HepEm_STEP_COUNTERS) || defined(G4HepEm_USDT_PROBES)
+  const std::size_t numStackedBefore = secondaries.size();
+#endif
+#ifdef G4HepEm_STEP_COUNTERS
+  // number of secondaries rejected by the leading particle biasing (not cuts)
+  int numRejected = 0;
+#endif
   for (int is = 0; is < numSecElectron; ++is) {
     G4HepEmTrack *secTrack = aTLData->GetSecondaryElectronTrack(is)->GetTrack();
     const double  secEKin  = secTrack->GetEKin();
     const bool isElectron  = secTrack->GetCharge() < 0.0;
+    // the (relative) weight of the secondary (1 unless biasing is active)
+    // zero if it was rejected by the leading particle biasing: nothing to do
+    const double secWeight = secTrack->GetWeight();
+    if (secWeight <= 0.0) {
+#ifdef G4HepEm_STEP_COUNTERS
+      ++numRejected;
+#endif
+      continue;
+    }
+    if (isElectron && isElectronTrackingCut && secEKin <= theRegionPars.fElectronTrackingCut) {
+      edep += secEKin*secWeight;
+      continue;
+    }
     if (isApplyCuts) {
       if (isElectron && secEKin < (*theCutsElectron)[aG4IMC]) {
-        edep += secEKin;
+        edep += secEKin*secWeight;
         continue;
       } else if (!isElectron &&
                  CLHEP::electron_mass_c2 < (*theCutsGamma)[aG4IMC] &&
                  secEKin < (*theCutsPositron)[aG4IMC]) {
-        edep += secEKin + 2 * CLHEP::electron_mass_c2;
+        edep += (secEKin + 2 * CLHEP::electron_mass_c2)*secWeight;
         continue;
       }
     }
@@ -1270,7 +1884,7 @@ double G4HepEmTrackingManager::StackSecondaries(G4HepEmTLData* aTLData, G4Track*
     aG4Track->SetParentID(theG4ParentTrackID);
     aG4Track->SetCreatorProcess(aG4CreatorProcess);
     aG4Track->SetTouchableHandle(theG4TouchableHandle);
-    aG4Track->SetWeight(theG4ParentTrackWeight);
+    aG4Track->SetWeight(theG4ParentTrackWeight*secWeight);
     secondaries.push_back(aG4Track);
   }
   aTLData->ResetNumSecondaryElectronTrack();
@@ -1278,8 +1892,17 @@ double G4HepEmTrackingManager::StackSecondaries(G4HepEmTLData* aTLData, G4Track*
   for (int is = 0; is < numSecGamma; ++is) {
     G4HepEmTrack *secTrack = aTLData->GetSecondaryGammaTrack(is)->GetTrack();
     const double secEKin = secTrack->GetEKin();
-    if (isApplyCuts && secEKin < (*theCutsGamma)[aG4IMC]) {
-      edep += secEKin;
+    // the (relative) weight of the secondary (not 1 e.g. in case of brem splitting)
+    // zero if it was rejected by the leading particle biasing: nothing to do
+    const double secWeight = secTrack->GetWeight();
+    if (secWeight <= 0.0) {
+#ifdef G4HepEm_STEP_COUNTERS
+      ++numRejected;
+#endif
+      continue;
+    }
+    if ((isApplyCuts && secEKin < (*theCutsGamma)[aG4IMC]) || secEKin <= theRegionPars.fGammaTrackingCut) {
+      edep += secEKin*secWeight;
       continue;
     }
 
@@ -1292,11 +1915,19 @@ double G4HepEmTrackingManager::StackSecondaries(G4HepEmTLData* aTLData, G4Track*
     aG4Track->SetParentID(theG4ParentTrackID);
     aG4Track->SetCreatorProcess(aG4CreatorProcess);
     aG4Track->SetTouchableHandle(theG4TouchableHandle);
-    aG4Track->SetWeight(theG4ParentTrackWeight);
+    aG4Track->SetWeight(theG4ParentTrackWeight*secWeight);
     secondaries.push_back(aG4Track);
   }
   aTLData->ResetNumSecondaryGammaTrack();
 
+#ifdef G4HepEm_STEP_COUNTERS
+  {
+    const int numStacked = secondaries.size() - numStackedBefore;
+    fStepCounters->CountSecondaries(theIRegion, GetStepCounterParticleID(aG4PrimaryTrack),
+                                    numStacked, numSecondaries - numRejected - numStacked);
+  }
+#endif
+  G4HepEmProbe3(stacking, numSecondaries, static_cast<int>(secondaries.size() - numStackedBefore), theHepEmIMC);
   return edep;
 }
 
@@ -1321,6 +1952,9 @@ double G4HepEmTrackingManager::StackG4Secondaries(G4VParticleChange* particleCha
   const double             theG4ParentTrackWeight     = aG4PrimaryTrack->GetWeight();
   const int                theG4ParentTrackID         = aG4PrimaryTrack->GetTrackID();
 
+#if defined(G4HepEm_STEP_COUNTERS) || defined(G4HepEm_USDT_PROBES)
+  const std::size_t numStackedBefore = secondaries.size();
+#endif
   for (int isec=0; isec<particleChange->GetNumberOfSecondaries(); ++isec) {
     G4Track *secTrack = particleChange->GetSecondary(isec);
     double   secEKin  = secTrack->GetKineticEnergy();
@@ -1346,6 +1980,18 @@ double G4HepEmTrackingManager::StackG4Secondaries(G4VParticleChange* particleCha
     secondaries.push_back(secTrack);
   }
 
+#ifdef G4HepEm_STEP_COUNTERS
+  {
+    const G4HepEmData* theHepEmData = fRunManager->GetHepEmData();
+    const int theHepEmIMC = theHepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex[aG4IMC];
+    const int theIRegion  = theHepEmData->fTheMatCutData->fMatCutData[theHepEmIMC].fG4RegionIndex;
+    const int numStacked  = secondaries.size() - numStackedBefore;
+    fStepCounters->CountSecondaries(theIRegion, GetStepCounterParticleID(aG4PrimaryTrack),
+                                    numStacked, numSecondaries - numStacked);
+  }
+#endif
+  G4HepEmProbe3(stacking, numSecondaries, static_cast<int>(secondaries.size() - numStackedBefore),
+                fRunManager->GetHepEmData()->fTheMatCutData->fG4MCIndexToHepEmMCIndex[aG4IMC]);
   return edep;
 }
 
@@ -1430,6 +2076,179 @@ void G4HepEmTrackingManager::InitFastSimRelated(int particleID) {
   }
 }
 
+// Try to get the step limiter and user special cuts processes of the particle
+// and cache the user limits of all logical volumes
+void G4HepEmTrackingManager::InitUserLimitsRelated(int particleID) {
+  G4ParticleDefinition* particleDef = nullptr;
+  switch(particleID) {
+    case 0: particleDef = G4Electron::Definition();
+            break;
+    case 1: particleDef = G4Positron::Definition();
+            break;
+    case 2: particleDef = G4Gamma::Definition();
+            break;
+  }
+  if (particleDef == nullptr) {
+    std::cerr << " *** Unknown particle in G4HepEmTrackingManager::InitUserLimitsRelated with ID = "
+              << particleID
+              << std::endl;
+    exit(-1);
+  }
+  fStepLimiterProcess[particleID]     = nullptr;
+  fUserSpecialCutsProcess[particleID] = nullptr;
+  const G4ProcessVector* processVector = particleDef->GetProcessManager()->GetProcessList();
+  for (std::size_t ip=0; ip<processVector->entries(); ip++) {
+    G4VProcess* proc = (*processVector)[ip];
+    if (proc->GetProcessType() != G4ProcessType::fGeneral) {
+      continue;
+    }
+    if (proc->GetProcessSubType() == STEP_LIMITER) {
+      fStepLimiterProcess[particleID] = proc;
+    } else if (proc->GetProcessSubType() == USER_SPECIAL_CUTS) {
+      fUserSpecialCutsProcess[particleID] = proc;
+    }
+  }
+  // (Re)build the cache of the user limits of the logical volumes
+  // NOTE: the limits are obtained once, at initialisation, so track dependent
+  //       user limits (i.e. derived from `G4UserLimits`) are not supported.
+  G4LogicalVolumeStore* lvStore = G4LogicalVolumeStore::GetInstance();
+  G4bool hasUserLimits = false;
+  fUserLimitsPerLogVol.clear();
+  for (auto* lv : *lvStore) {
+    const std::size_t indx = lv->GetInstanceID();
+    if (indx >= fUserLimitsPerLogVol.size()) {
+      fUserLimitsPerLogVol.resize(indx+1);
+    }
+    G4UserLimits* userLimits = lv->GetUserLimits();
+    if (userLimits == nullptr) {
+      continue;
+    }
+    G4Track dummyTrack;
+    UserLimitsData& data = fUserLimitsPerLogVol[indx];
+    data.fMaxStep        = userLimits->GetMaxAllowedStep(dummyTrack);
+    data.fMaxTrackLength = userLimits->GetUserMaxTrackLength(dummyTrack);
+    data.fMaxTime        = userLimits->GetUserMaxTime(dummyTrack);
+    data.fMinEKin        = userLimits->GetUserMinEkine(dummyTrack);
+    data.fMinRange       = userLimits->GetUserMinRange(dummyTrack);
+    data.fHasUserLimits  = true;
+    hasUserLimits        = true;
+  }
+  fIsUserLimits[particleID] = hasUserLimits && (fStepLimiterProcess[particleID] != nullptr ||
+                                                fUserSpecialCutsProcess[particleID] != nullptr);
+}
+
+
+G4double G4HepEmTrackingManager::ComputeUserLimitsStep(int indxLogVol, const G4Track& track, int particleID, G4double range, const G4VProcess** limitingProc, G4bool& isKill) const {
+  const UserLimitsData& data = fUserLimitsPerLogVol[indxLogVol];
+  G4double step = DBL_MAX;
+  isKill = false;
+  // `G4StepLimiter`: max allowed step
+  if (fStepLimiterProcess[particleID] != nullptr && data.fMaxStep < step) {
+    step = data.fMaxStep;
+    *limitingProc = fStepLimiterProcess[particleID];
+  }
+  // `G4UserSpecialCuts`: min kinetic energy, max track length, max time and
+  // min (remaining) range (only for e-/e+) with kill when reached
+  G4VProcess* specialCuts = fUserSpecialCutsProcess[particleID];
+  if (specialCuts == nullptr) {
+    return step;
+  }
+  G4double cutsStep = 0.0;
+  if (track.GetKineticEnergy() > data.fMinEKin) {
+    cutsStep = data.fMaxTrackLength - track.GetTrackLength();
+    if (data.fMaxTime < DBL_MAX) {
+      cutsStep = std::min(cutsStep, (data.fMaxTime - track.GetGlobalTime())*track.GetVelocity());
+    }
+    if (particleID < 2 && data.fMinRange > DBL_MIN) {
+      cutsStep = std::min(cutsStep, range - data.fMinRange);
+    }
+  }
+  if (cutsStep <= 0.0) {
+    isKill = true;
+    *limitingProc = specialCuts;
+    return 0.0;
+  }
+  if (cutsStep < step) {
+    step = cutsStep;
+    *limitingProc = specialCuts;
+  }
+  return step;
+}
+
+
+void G4HepEmTrackingManager::KillTrackInZeroStep(G4Step& step, const G4VProcess* proc, G4LogicalVolume* lvol, G4UserSteppingAction* userSteppingAction, G4VTrajectory* trajectory, int particleID, G4bool isDeposit) {
+  G4Track* track = step.GetTrack();
+  G4StepPoint& postStepPoint = *step.GetPostStepPoint();
+  const G4double ekin = isDeposit ? track->GetKineticEnergy() : 0.0;
+  step.SetStepLength(0.0);
+  postStepPoint.SetStepStatus(fPostStepDoItProc);
+  postStepPoint.SetProcessDefinedStep(proc);
+  postStepPoint.SetKineticEnergy(0.0);
+  track->SetTrackStatus(fStopAndKill);
+  step.UpdateTrack();
+  step.AddTotalEnergyDeposit(ekin);
+  if (fScoringMesh != nullptr && ekin > 0.0) {
+    const G4ThreeVector& postPoint = postStepPoint.GetPosition();
+    fScoringMesh->Fill(postPoint.x(), postPoint.y(), postPoint.z(), ekin*step.GetPreStepPoint()->GetWeight());
+  }
+  // End of this step: call the SD codes and required actions
+  if (step.GetControlFlag() != AvoidHitInvocation) {
+    auto* sensitive = lvol->GetSensitiveDetector();
+    if (sensitive) {
+      fHitAggregator->Invoke(sensitive, step, fIsHitAggregation && fIsHitAggregationRegion[lvol->GetRegion()->GetInstanceID()]);
+    }
+  }
+  if (userSteppingAction) {
+    userSteppingAction->UserSteppingAction(&step);
+  }
+  if (fStepBatchAction != nullptr) {
+    RecordStep(step, lvol, particleID);
+  }
+  auto* regionalAction = lvol->GetRegion()->GetRegionalSteppingAction();
+  if (regionalAction) {
+    regionalAction->UserSteppingAction(&step);
+  }
+  if (trajectory != nullptr) {
+    trajectory->AppendStep(&step);
+  }
+}
+
+
+G4bool G4HepEmTrackingManager::ApplyWeightWindow(G4Track* aTrack, const G4HepEmRegionParmeters& regionPars, G4HepEmRandomEngine* rnge) {
+  // Upper limit of the number of tracks a single track can be split into
+  const G4int kMaxNumSplit = 100;
+  const G4double weight = aTrack->GetWeight();
+  G4double newWeight = weight;
+  if (weight < regionPars.fWeightWindowLower) {
+    // Russian roulette: survives with `weight/survival` probability
+    newWeight = G4HepEmWeightWindow::PlayRoulette(weight, regionPars.fWeightWindowSurvival, rnge->flat());
+    if (newWeight == 0.0) {
+      return false;
+    }
+  } else if (regionPars.fWeightWindowUpper > 0.0 && weight > regionPars.fWeightWindowUpper) {
+    // Splitting: `numSplit` identical tracks with `weight/numSplit` weights,
+    // i.e. this one and its clones that are stacked as secondaries
+    const G4int numSplit = G4HepEmWeightWindow::GetNumSplit(weight, regionPars.fWeightWindowUpper, kMaxNumSplit);
+    newWeight = weight/numSplit;
+    G4TrackVector& secondaries = *fStep->GetfSecondary();
+    for (G4int is=1; is<numSplit; ++is) {
+      G4Track* clone = new G4Track(new G4DynamicParticle(*aTrack->GetDynamicParticle()),
+                                   aTrack->GetGlobalTime(), aTrack->GetPosition());
+      clone->SetParentID(aTrack->GetTrackID());
+      clone->SetCreatorProcess(fWeightWindowNoProcess);
+      clone->SetTouchableHandle(aTrack->GetTouchableHandle());
+      clone->SetWeight(newWeight);
+      secondaries.push_back(clone);
+    }
+  }
+  // NOTE: the track weight is updated from the post-step point at the end of the step
+  aTrack->SetWeight(newWeight);
+  fStep->GetPreStepPoint()->SetWeight(newWeight);
+  fStep->GetPostStepPoint()->SetWeight(newWeight);
+  return true;
+}
+
+
 // ATLAS XTR RELATED:
 void G4HepEmTrackingManager::InitXTRRelated() {
   // Try to get the pointer to the detector region that contains the TRT radiators
@@ -1488,8 +2307,20 @@ void G4HepEmTrackingManager::ReportExtraProcesses(int particleID) {
                  pFastSim->GetProcessName() + " )";
   }
 
+  std::string strUserLimits = "User limits processes : have not been found. ";
+  if (fStepLimiterProcess[particleID] != nullptr || fUserSpecialCutsProcess[particleID] != nullptr) {
+    strUserLimits = "User limits processes : have been found (";
+    if (fStepLimiterProcess[particleID] != nullptr) {
+      strUserLimits += " " + fStepLimiterProcess[particleID]->GetProcessName();
+    }
+    if (fUserSpecialCutsProcess[particleID] != nullptr) {
+      strUserLimits += " " + fUserSpecialCutsProcess[particleID]->GetProcessName();
+    }
+    strUserLimits += " )";
+  }
+
   std::cout << " --- G4HepEmTrackingManager: extra processes for " << partName << "\n";
-  std::cout << "     " << strNuclear << "\n     " << strFastSim << std::endl;
+  std::cout << "     " << strNuclear << "\n     " << strFastSim << "\n     " << strUserLimits << std::endl;
   if (particleID == 0 || particleID == 1) { //e-/e+
     std::string strXTRProc = "The special XTR process : has not been found. ";
     if (fXTRProcess != nullptr) {
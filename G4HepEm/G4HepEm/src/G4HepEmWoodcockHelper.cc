@@ -7,39 +7,91 @@
 #include "G4LogicalVolume.hh"
 #include "G4VPhysicalVolume.hh"
 #include "G4RegionStore.hh"
+#include "G4LogicalVolumeStore.hh"
 
 #include "G4Track.hh"
 #include "G4TouchableHistory.hh"
 #include "G4NavigationHistory.hh"
 #include "G4TransportationManager.hh"
-
-#include "Randomize.hh"
+#include "G4Threading.hh"
 
 #include "G4HepEmData.hh"
 #include "G4HepEmMatCutData.hh"
+#include "G4HepEmMaterialData.hh"
+#include "G4HepEmGammaData.hh"
 #include "G4HepEmGammaTrack.hh"
+#include "G4HepEmMath.hh"
+#include "G4HepEmRandomEngine.hh"
 
 #include "G4HepEmGammaManager.hh"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+G4HepEmWoodcockHelper* G4HepEmWoodcockHelper::gTheMasterWoodcockHelper = nullptr;
+
 G4HepEmWoodcockHelper::G4HepEmWoodcockHelper()
 : fWDTSolid(nullptr),
-  fWDTCouple(nullptr),
-  fWDTHepEmIMC(-1),
-  fWDTKineticEnergyLimit(0.2) // 200 keV
-{ }
+  fWDTMajorantMXsec(nullptr),
+  fWDTVoxelMap(nullptr),
+  fWDTExclusionZones(nullptr),
+  fMajorantNumEnergies(0),
+  fMajorantLogEMin(0.0),
+  fMajorantInvLogDelta(0.0),
+  fIsMaster(G4Threading::IsMasterThread()),
+  fRandomIndex(kRandomBufferSize),
+  fWDTKineticEnergyLimit(0.2), // 200 keV
+  fWDTVoxelSize(0.0)
+{
+  InitMajorantEnergyGrid();
+}
 
 
 G4HepEmWoodcockHelper::~G4HepEmWoodcockHelper() {
+  // NOTE: the workers keep the shared voxel maps alive (if any)
+  if (gTheMasterWoodcockHelper == this) {
+    gTheMasterWoodcockHelper = nullptr;
+  }
   ClearData();
 }
 
 
-G4bool G4HepEmWoodcockHelper::Initialize(std::vector<std::string>& wdtRegionNames, struct G4HepEmMatCutData* hepEmMatCutData, G4VPhysicalVolume* worldVolume) {
+void G4HepEmWoodcockHelper::SetKineticEnergyLimit(G4double val) {
+  fWDTKineticEnergyLimit = val;
+  InitMajorantEnergyGrid();
+}
+
+
+void G4HepEmWoodcockHelper::InitMajorantEnergyGrid() {
+  // The energy grid of the majorant tables: log-spaced with 50 bins per decade
+  // between the WDT kinetic energy limit (at least 1 keV) and 100 TeV.
+  const G4double kMajorantEMin = std::max(fWDTKineticEnergyLimit, 1.0E-3);
+  const G4double kMajorantEMax = 1.0E+8;
+  const G4int    kBinsPerDecade = 50;
+  fMajorantNumEnergies = std::max(2, (G4int)(kBinsPerDecade*std::log10(kMajorantEMax/kMajorantEMin)) + 1);
+  fMajorantLogEMin     = G4Log(kMajorantEMin);
+  fMajorantInvLogDelta = (fMajorantNumEnergies-1)/(G4Log(kMajorantEMax)-fMajorantLogEMin);
+}
+
+
+G4bool G4HepEmWoodcockHelper::Initialize(std::vector<std::string>& wdtRegionNames, const struct G4HepEmData* hepEmData, G4VPhysicalVolume* worldVolume) {
   // make sure that all data are cleared
   ClearData();
+  // Size the dense lookup tables by the maximum region and logical volume IDs.
   // NOTE: I will alway know that a given region is Woodcock region or not by
-  // checking if the region ID is in the `fWDTData` map. And do not need to check
-  // in each step during the tracking: as long as the region stays the same.
+  // checking its flag. And do not need to check in each step during the
+  // tracking: as long as the region stays the same.
+  G4int maxRegionID = -1;
+  for (const G4Region* region : *G4RegionStore::GetInstance()) {
+    maxRegionID = std::max(maxRegionID, region->GetInstanceID());
+  }
+  G4int maxLogVolID = -1;
+  for (const G4LogicalVolume* lvol : *G4LogicalVolumeStore::GetInstance()) {
+    maxLogVolID = std::max(maxLogVolID, lvol->GetInstanceID());
+  }
+  fIsWDTRegion.assign(maxRegionID+1, false);
+  fWDTRootIndexPerLogVol.assign(maxLogVolID+1, -1);
   //
   G4bool oneHasBeenFound = false;
   // Try to find the Woodcock tracking regions (one-by-one) in the store by using
@@ -49,11 +101,9 @@ G4bool G4HepEmWoodcockHelper::Initialize(std::vector<std::string>& wdtRegionName
     const std::string& wdtRegionName = wdtRegionNames[ir];
     G4Region* wdtRegion = G4RegionStore::GetInstance()->GetRegion(wdtRegionName, false);
     if (wdtRegion != nullptr) {
-      oneHasBeenFound = true;
-      // Found a region with the given name: set Region ID to index map element
-      // Create a WDT data for this region and store in the `fWDTData` map
-      WDTDataForARegion* wdtDataRegion = new WDTDataForARegion();
-      fWDTData[wdtRegion->GetInstanceID()] = wdtDataRegion;
+      // Found a region with the given name: set its flag
+      const G4int regionID = wdtRegion->GetInstanceID();
+      fIsWDTRegion[regionID] = true;
       // Iterate the root logical volumes of this region.
       // Find and store their solid and the heaviest material within each
       int numRootLVolume = wdtRegion->GetNumberOfRootVolumes();
@@ -66,20 +116,37 @@ G4bool G4HepEmWoodcockHelper::Initialize(std::vector<std::string>& wdtRegionName
         G4LogicalVolume* rootLogVol = (*itrLV);
         // std::cout << " The [ " << ilv << " ]-th root logical volume is "
         //          << rootLogVol->GetName() << std::endl;
-        G4double maxDensity = -1.0;
-        G4Material*  wdtMat = nullptr;
-        // find the material with maximum density in this root logical volume branch
-        FindWDTMaterial(rootLogVol, maxDensity, &wdtMat);
-        G4MaterialCutsCouple* wdtCouple = wdtRegion->FindCouple(wdtMat);
-        // std::cout << " The heaviest material in this branch is " << wdtMat->GetName()
-        //          << " wdtCouple indx = " << wdtCouple->GetIndex()
-        //          << " wdTMat name = " << wdtMat->GetName()
-        //          << std::endl;
+        // find all the material-cuts couples in this root logical volume branch
+        // (and the volumes of the sub-regions, if any, as exclusion zones)
+        std::vector<G4int> hepEmIMCs;
+        std::vector<WDTExclusionZone> exclusionZones;
+        if (!FindWDTMatCuts(rootLogVol, wdtRegion, hepEmData->fTheMatCutData, hepEmIMCs,
+                            G4AffineTransform(), true, exclusionZones)) {
+          // not supported: normal tracking in this root logical volume
+          std::cerr << "     Woodcock tracking is turned off in the root logical volume: "
+                    << rootLogVol->GetName() << std::endl;
+          ++itrLV;
+          continue;
+        }
+        oneHasBeenFound = true;
         // Create a `WDTDataPerRootLogVol`structure for this root logical volume
-        // set all required fields and store in the map indexed(key) by the log. vol. ID
-        const int hepEmIMC = hepEmMatCutData->fG4MCIndexToHepEmMCIndex[wdtCouple->GetIndex()];
-        WDTDataPerRootLogVol* wdtDataRootLogVol = new WDTDataPerRootLogVol(rootLogVol->GetSolid(), wdtCouple, hepEmIMC);
-        wdtDataRegion->fWDTDataRegion[rootLogVol->GetInstanceID()] = wdtDataRootLogVol;
+        // set all required fields (incl. the majorant table over all these couples)
+        // and store its index at the log. vol. ID
+        fWDTRootIndexPerLogVol[rootLogVol->GetInstanceID()] = fWDTRootLogVolData.size();
+        fWDTRootLogVolData.emplace_back(rootLogVol->GetSolid(), regionID);
+        fWDTRootLogVolData.back().fExclusionZones = std::move(exclusionZones);
+        BuildMajorantMXsec(hepEmData, hepEmIMCs, fWDTRootLogVolData.back().fMajorantMXsec);
+        // build the material voxel map of this root logical volume if requested:
+        // only once by the master while the workers share that (read-only)
+        if (fWDTVoxelSize > 0.0) {
+          std::shared_ptr<const WDTVoxelMap> voxelMap = GetMasterVoxelMap(rootLogVol);
+          if (voxelMap == nullptr) {
+            std::shared_ptr<WDTVoxelMap> newVoxelMap = std::make_shared<WDTVoxelMap>();
+            BuildVoxelMap(rootLogVol, hepEmData->fTheMatCutData->fG4MCIndexToHepEmMCIndex, *newVoxelMap);
+            voxelMap = newVoxelMap;
+          }
+          fWDTRootLogVolData.back().fVoxelMap = voxelMap;
+        }
         ++itrLV;
       }
     } else {
@@ -92,6 +159,10 @@ G4bool G4HepEmWoodcockHelper::Initialize(std::vector<std::string>& wdtRegionName
   if (oneHasBeenFound) {
     // Set the world volume of the WDT navigator
     fWDTNavigator.SetWorldVolume(worldVolume);
+    // The workers (initialised after the master) will share the voxel maps
+    if (fIsMaster) {
+      gTheMasterWoodcockHelper = this;
+    }
   }
   return oneHasBeenFound;
 }
@@ -99,19 +170,19 @@ G4bool G4HepEmWoodcockHelper::Initialize(std::vector<std::string>& wdtRegionName
 
 G4bool G4HepEmWoodcockHelper::FindWDTVolume(int regionID, const G4Track& aTrack) {
   // Early return if this step is not in a WDT region or kinetic energy is too low
-  if ( fWDTData.find(regionID) == fWDTData.end() || aTrack.GetKineticEnergy() < fWDTKineticEnergyLimit) {
+  if ( regionID >= (int)fIsWDTRegion.size() || !fIsWDTRegion[regionID] || aTrack.GetKineticEnergy() < fWDTKineticEnergyLimit) {
     return false;
   }
-  // Obtain the Woodcock tracking data stored for the actual region
-  WDTDataForARegion* wdtDataRegion = fWDTData[regionID];
-  // Find the actual root logical volume within this step is done
+  // Find the actual root logical volume (of the actual region) within this step is done
   // NOTE: it doesn't change the state of the touchable so I can keep tracking after
   const G4NavigationHistory* navHistory = ((G4TouchableHistory*)(aTrack.GetTouchableHandle()()))->GetHistory();
+  const int numLogVols = fWDTRootIndexPerLogVol.size();
   int currentDepth = navHistory->GetDepth();
-  std::map<G4int, WDTDataPerRootLogVol*>::iterator itr;
+  int indxRoot = -1;
   while (currentDepth > -1) {
-    itr = wdtDataRegion->fWDTDataRegion.find(navHistory->GetVolume(currentDepth)->GetLogicalVolume()->GetInstanceID());
-    if (itr != wdtDataRegion->fWDTDataRegion.end()) {
+    const int logVolID = navHistory->GetVolume(currentDepth)->GetLogicalVolume()->GetInstanceID();
+    indxRoot = logVolID < numLogVols ? fWDTRootIndexPerLogVol[logVolID] : -1;
+    if (indxRoot > -1 && fWDTRootLogVolData[indxRoot].fRegionID == regionID) {
       break;
     }
     // moving one level up in the geometry tree
@@ -122,13 +193,15 @@ G4bool G4HepEmWoodcockHelper::FindWDTVolume(int regionID, const G4Track& aTrack)
     return false;
   }
   // Get the WDT data for the root logical volume in which the actual tracking happens
-  WDTDataPerRootLogVol* wdtDataRootLogVol = itr->second;
+  const WDTDataPerRootLogVol* wdtDataRootLogVol = &fWDTRootLogVolData[indxRoot];
   // Obtain the actual transformation: used to transform the actual point/direction to
   // volume local before computing the distance to its boundary.
-  fWDTTransform = navHistory->GetTransform(currentDepth);
-  fWDTHepEmIMC  = wdtDataRootLogVol->fG4CoupleHepEmIndex;
-  fWDTSolid     = wdtDataRootLogVol->fSolid;
-  fWDTCouple    = wdtDataRootLogVol->fG4Couple;
+  fWDTTransform     = navHistory->GetTransform(currentDepth);
+  fWDTSolid         = wdtDataRootLogVol->fSolid;
+  fWDTMajorantMXsec = wdtDataRootLogVol->fMajorantMXsec.data();
+  const WDTVoxelMap* voxelMap = wdtDataRootLogVol->fVoxelMap.get();
+  fWDTVoxelMap      = (voxelMap == nullptr || voxelMap->fHepEmIMC.empty()) ? nullptr : voxelMap;
+  fWDTExclusionZones = &(wdtDataRootLogVol->fExclusionZones);
   //
   // Check if the current pre-step point is indeed inside. If distance to
   // the root volume boundary is zero (or very small) then just do normal
@@ -138,12 +211,12 @@ G4bool G4HepEmWoodcockHelper::FindWDTVolume(int regionID, const G4Track& aTrack)
   const G4ThreeVector& v0 = aTrack.GetMomentumDirection();
   const G4ThreeVector localPoint     = fWDTTransform.TransformPoint(r0);
   const G4ThreeVector localDirection = fWDTTransform.TransformAxis(v0);
-  G4double distToBoundary = std::max(fWDTSolid->DistanceToOut(localPoint, localDirection)-1.0E-3, 0.0 );
+  G4double distToBoundary = std::max(DistanceToBoundary(localPoint, localDirection)-1.0E-3, 0.0 );
   return (distToBoundary < 1.0E-6) ? false : true;
 }
 
 
-G4bool G4HepEmWoodcockHelper::KeepTracking(const struct G4HepEmData* theHepEmData, G4HepEmGammaTrack* theGammaTrack, G4Track& aTrack) {
+G4bool G4HepEmWoodcockHelper::KeepTracking(const struct G4HepEmData* theHepEmData, G4HepEmGammaTrack* theGammaTrack, G4Track& aTrack, G4HepEmRandomEngine* rnge) {
   // Calculate the distance to boundary and the physics length keep eating up
   // the distance to boundary till: 1. interaction is reached or close to boundary.
   // In both cases, locate the point before going further, then either make
@@ -152,24 +225,22 @@ G4bool G4HepEmWoodcockHelper::KeepTracking(const struct G4HepEmData* theHepEmDat
   G4StepPoint& preStepPoint  = *(aTrack.GetStep()->GetPreStepPoint());
   G4StepPoint& postStepPoint = *(aTrack.GetStep()->GetPostStepPoint());
 
-  // Compute the distance to the boundary of the actual root volume.
+  // Compute the distance to the boundary of the actual root volume (or to the
+  // closest sub-region volume inside, i.e. exclusion zone, if any).
   // - get direction and start position
   const G4ThreeVector& r0 = preStepPoint.GetPosition();
   const G4ThreeVector& v0 = preStepPoint.GetMomentumDirection();
   const G4ThreeVector localPoint     = fWDTTransform.TransformPoint(r0);
   const G4ThreeVector localDirection = fWDTTransform.TransformAxis(v0);
-  G4double distToBoundary = std::max( fWDTSolid->DistanceToOut(localPoint, localDirection)-1.0E-3, 0.0 );
+  G4double distToBoundary = std::max( DistanceToBoundary(localPoint, localDirection)-1.0E-3, 0.0 );
   // When `distToBoundary = 0`, we are within 1.0E-3 to the the boundary.
   //
-  // Compute the WDT reference mxsec (i.e. maximum total mxsec along this setp).
-  // (need to set only the MC index as ekin has alrady been set above).
+  // Get the WDT reference mxsec (i.e. maximum total mxsec along this setp) from
+  // the majorant table of the actual root volume (ekin has alrady been set above).
   G4HepEmTrack* thePrimaryTrack = theGammaTrack->GetTrack();
-  thePrimaryTrack->SetMCIndex(fWDTHepEmIMC);
-  const G4double wdtMXsec   = G4HepEmGammaManager::GetTotalMacXSec(theHepEmData, theGammaTrack);
+  const G4double wdtMXsec   = GetMajorantMXsec(thePrimaryTrack->GetEKin());
   const G4double wdtMFP     = wdtMXsec > 0.0 ? 1.0/wdtMXsec : DBL_MAX;
-  const G4double wdtPEmxSec = theGammaTrack->GetPEmxSec();
   // Init some variables before starting Woodcock tracking of the gamma
-  const G4Material* wdtMaterial = fWDTCouple->GetMaterial();
   G4double mxsec = 0.0;
   G4int prevHepEmIMC = -1;
   G4bool doStop = false;
@@ -180,7 +251,7 @@ G4bool G4HepEmWoodcockHelper::KeepTracking(const struct G4HepEmData* theHepEmDat
   G4bool isWDTReachedBoundary = false;
   while (!doStop) {
     // Compute the step length till the next interaction in the WDT material
-    const G4double pstep = wdtMFP < DBL_MAX ? -G4Log( G4UniformRand() )*wdtMFP : DBL_MAX;
+    const G4double pstep = wdtMFP < DBL_MAX ? -G4HepEmLog( GetRandom(rnge) )*wdtMFP : DBL_MAX;
     // Take the minimum of this and the distance to the WDT root volume boundary
     // while checking if this step ends up close to the volume boundary
     if (distToBoundary < pstep) {
@@ -192,51 +263,43 @@ G4bool G4HepEmWoodcockHelper::KeepTracking(const struct G4HepEmData* theHepEmDat
       // distance to boundary accordingly.
       wdtStepLength  += pstep;
       distToBoundary -= pstep;
-      // Locate the actual post step point in order to get the real material.
-      // NOTE: we might start here from a certain depth (i.e. from the depth of
-      //       the actual root logical volume)
-      const G4VPhysicalVolume* pVol = fWDTNavigator.LocateGlobalPointAndSetup(r0+wdtStepLength*v0, nullptr, true, true);
-      const G4LogicalVolume*   lVol = pVol->GetLogicalVolume();
-      const G4Material* postStepMat = lVol->GetMaterial();
-      // Check if the real material of the post-step point is the WDT one?
-      if (wdtMaterial != postStepMat) {
-        // Post step point is NOT in the WDT material: need to check if interacts.
-        // Compute the total macroscopic cross section for that material.
+      // Get the real material at the actual post step point: from the voxel
+      // map of the root volume (if any) when the voxel is not mixed.
+      int hepEmIMC = fWDTVoxelMap != nullptr
+                     ? fWDTVoxelMap->GetHepEmIMC(localPoint+wdtStepLength*localDirection)
+                     : -1;
+      if (hepEmIMC < 0) {
+        // Locate the actual post step point in order to get the real material.
+        // NOTE: we might start here from a certain depth (i.e. from the depth of
+        //       the actual root logical volume)
+        const G4VPhysicalVolume* pVol = fWDTNavigator.LocateGlobalPointAndSetup(r0+wdtStepLength*v0, nullptr, true, true);
+        const G4LogicalVolume*   lVol = pVol->GetLogicalVolume();
         const G4MaterialCutsCouple* couple = lVol->GetMaterialCutsCouple();
-        const int hepEmIMC = g4MCIndexToHepEmMCIndex[couple->GetIndex()];
-        if (hepEmIMC != prevHepEmIMC) {
-          // Recompute the total macroscopic cross section only if the material
-          // has changed compared to the previous computation (energy stays const.)
-          prevHepEmIMC = hepEmIMC;
-          thePrimaryTrack->SetMCIndex(hepEmIMC);
-          mxsec = G4HepEmGammaManager::GetTotalMacXSec(theHepEmData, theGammaTrack);
-        }
-        // Sample if interaction happens at this post step point:
-        // P(interact) = preStepLambda/wdckMXsec note: preStepLambda <= wdckMXsec
-        doStop = (mxsec*wdtMFP > G4UniformRand());
-        if (doStop) {
-          // Interaction happens: set the track fields required later.
-          // Set the total MFP of the track that will be needed when sampling
-          // the type of the interaction. The HepEm MC index is already set
-          // above while the g4 one is also set here.
-          const double mfp = mxsec > 0.0 ? 1.0/mxsec : DBL_MAX;
-          thePrimaryTrack->SetMFP(mfp, 0);
-          // g4IMC = couple->GetIndex();
-          // NOTE: PE mxsec is correct as the last call to `GetTotalMacXSec`
-          // was fone above for this material.
-        }
-      } else {
-        // Post step point is in the WDT material: interacts for sure (prob.=1)
-        // Set the total MFP and MC index of the track that will be needed when
-        // sampling the type of the interaction. The g4 MC index is also set here.
-        doStop = true;
-        thePrimaryTrack->SetMCIndex(fWDTHepEmIMC);
-        thePrimaryTrack->SetMFP(wdtMFP, 0);
-        // g4IMC = fWDTHelper->fWDTCouple->GetIndex();
-        // Reset the PE mxsec: set in `G4HepEmGammaManager::GetTotalMacXSec`
-        // that might have been called for an other material above (without
-        // resulting in interaction). Needed for the interaction type sampling.
-        theGammaTrack->SetPEmxSec(wdtPEmxSec);
+        hepEmIMC = g4MCIndexToHepEmMCIndex[couple->GetIndex()];
+      }
+      // Compute the total macroscopic cross section for the real material of
+      // the post-step point: need to check if interacts.
+      if (hepEmIMC != prevHepEmIMC) {
+        // Recompute the total macroscopic cross section only if the material
+        // has changed compared to the previous computation (energy stays const.)
+        prevHepEmIMC = hepEmIMC;
+        thePrimaryTrack->SetMCIndex(hepEmIMC);
+        mxsec = G4HepEmGammaManager::GetTotalMacXSec(theHepEmData, theGammaTrack);
+        // the majorant must not be exceeded (otherwise the sampling is biased)
+        assert(mxsec <= wdtMXsec*(1.0+1.0E-12) && "Woodcock tracking: the majorant is below the real mac. xsec");
+      }
+      // Sample if interaction happens at this post step point:
+      // P(interact) = preStepLambda/wdckMXsec note: preStepLambda <= wdckMXsec
+      doStop = (mxsec*wdtMFP > GetRandom(rnge));
+      if (doStop) {
+        // Interaction happens: set the track fields required later.
+        // Set the total MFP of the track that will be needed when sampling
+        // the type of the interaction. The HepEm MC index is already set
+        // above.
+        const double mfp = mxsec > 0.0 ? 1.0/mxsec : DBL_MAX;
+        thePrimaryTrack->SetMFP(mfp, 0);
+        // NOTE: PE mxsec is correct as the last call to `GetTotalMacXSec`
+        // was done above for this material.
       }
     }
 
@@ -299,44 +362,242 @@ G4bool G4HepEmWoodcockHelper::KeepTracking(const struct G4HepEmData* theHepEmDat
 
 
 void G4HepEmWoodcockHelper::ClearData() {
-  // iterate over the `fWDTData` map
-  std::map<G4int, WDTDataForARegion*>::iterator itrRegion = fWDTData.begin();
-  for (; itrRegion != fWDTData.end(); itrRegion++) {
-    // iterate over the root logical volume data inside each reagion
-    WDTDataForARegion* dataForARegion = itrRegion->second;
-    std::map<G4int, WDTDataPerRootLogVol*>::iterator itrRootVol
-        = dataForARegion->fWDTDataRegion.begin();
-    for (; itrRootVol != dataForARegion->fWDTDataRegion.end(); itrRootVol++) {
-      // NOTE: we do not own the solid and the material-cuts couple (only store their ptr)
-      delete itrRootVol->second;
+  // NOTE: we do not own the solid and the material-cuts couple (only store their ptr)
+  fWDTRootLogVolData.clear();
+  fIsWDTRegion.clear();
+  fWDTRootIndexPerLogVol.clear();
+}
+
+
+std::shared_ptr<const G4HepEmWoodcockHelper::WDTVoxelMap>
+G4HepEmWoodcockHelper::GetMasterVoxelMap(const G4LogicalVolume* rootLogVol) const {
+  const G4HepEmWoodcockHelper* master = gTheMasterWoodcockHelper;
+  if (fIsMaster || master == nullptr || master->fWDTVoxelSize != fWDTVoxelSize) {
+    return nullptr;
+  }
+  const G4int logVolID = rootLogVol->GetInstanceID();
+  if (logVolID >= (G4int)master->fWDTRootIndexPerLogVol.size() || master->fWDTRootIndexPerLogVol[logVolID] < 0) {
+    return nullptr;
+  }
+  return master->fWDTRootLogVolData[master->fWDTRootIndexPerLogVol[logVolID]].fVoxelMap;
+}
+
+
+void G4HepEmWoodcockHelper::BuildVoxelMap(const G4LogicalVolume* rootLogVol,
+                                          const G4int* g4MCIndexToHepEmMCIndex,
+                                          WDTVoxelMap& voxelMap) {
+  // The map covers the bounding box of the root solid (in its local frame).
+  G4ThreeVector pMin, pMax;
+  rootLogVol->GetSolid()->BoundingLimits(pMin, pMax);
+  // Number of voxels along each axis: the voxel size is increased if that
+  // would result in more than the maximum number of voxels.
+  G4double voxelSize = fWDTVoxelSize;
+  G4double numVoxels = kMaxNumVoxels + 1.0;
+  while (numVoxels > kMaxNumVoxels) {
+    numVoxels = 1.0;
+    for (int i=0; i<3; ++i) {
+      voxelMap.fNumVoxels[i] = std::max(1, (G4int)std::ceil((pMax[i]-pMin[i])/voxelSize));
+      numVoxels *= voxelMap.fNumVoxels[i];
+    }
+    if (numVoxels > kMaxNumVoxels) {
+      voxelSize *= 1.1;
+    }
+  }
+  G4double size[3];
+  G4double halfDiagonal2 = 0.0;
+  for (int i=0; i<3; ++i) {
+    size[i]              = (pMax[i]-pMin[i])/voxelMap.fNumVoxels[i];
+    voxelMap.fMin[i]     = pMin[i];
+    voxelMap.fInvSize[i] = size[i] > 0.0 ? 1.0/size[i] : 0.0;
+    halfDiagonal2       += 0.25*size[i]*size[i];
+  }
+  const G4double halfDiagonal = std::sqrt(halfDiagonal2);
+  // A voxel is homogeneous if its centre is (strictly) inside a volume and the
+  // safety is larger than the half diagonal: the whole voxel is in that volume.
+  voxelMap.fHepEmIMC.resize((std::size_t)numVoxels, -1);
+  const G4VSolid* rootSolid = rootLogVol->GetSolid();
+  std::size_t indx = 0;
+  for (G4int ix=0; ix<voxelMap.fNumVoxels[0]; ++ix) {
+    for (G4int iy=0; iy<voxelMap.fNumVoxels[1]; ++iy) {
+      for (G4int iz=0; iz<voxelMap.fNumVoxels[2]; ++iz, ++indx) {
+        const G4ThreeVector centre(pMin[0]+(ix+0.5)*size[0],
+                                   pMin[1]+(iy+0.5)*size[1],
+                                   pMin[2]+(iz+0.5)*size[2]);
+        if (rootSolid->Inside(centre) != kInside) {
+          continue;
+        }
+        // NOTE: the root boundary is not considered as the tracking never
+        //       goes beyond that (see `KeepTracking`).
+        G4double safety = DBL_MAX;
+        const G4LogicalVolume* lvol = LocateInLogVol(rootLogVol, centre, safety);
+        if (lvol != nullptr && safety > halfDiagonal) {
+          voxelMap.fHepEmIMC[indx] = g4MCIndexToHepEmMCIndex[lvol->GetMaterialCutsCouple()->GetIndex()];
+        }
+      }
     }
-    dataForARegion->fWDTDataRegion.clear();
-    delete dataForARegion;
   }
-  fWDTData.clear();
 }
 
 
-void G4HepEmWoodcockHelper::FindWDTMaterial(G4LogicalVolume* lvol, double& maxDensity, G4Material** maxDensityMat) {
-  G4Material*  mat = lvol->GetMaterial();
-  G4double density = mat->GetDensity();
-  if (density > maxDensity) {
-    maxDensity = density;
-    *maxDensityMat = mat;
+const G4LogicalVolume* G4HepEmWoodcockHelper::LocateInLogVol(const G4LogicalVolume* lvol,
+                                                             const G4ThreeVector& localPoint,
+                                                             G4double& safety) const {
+  const std::size_t numDaughters = lvol->GetNoDaughters();
+  for (std::size_t id=0; id<numDaughters; ++id) {
+    const G4VPhysicalVolume* pvol = lvol->GetDaughter(id);
+    if (pvol->VolumeType() != kNormal) {
+      return nullptr;
+    }
+    G4AffineTransform transform(pvol->GetRotation(), pvol->GetTranslation());
+    transform.Invert();
+    const G4ThreeVector daughterPoint = transform.TransformPoint(localPoint);
+    const G4VSolid* solid = pvol->GetLogicalVolume()->GetSolid();
+    if (solid->Inside(daughterPoint) == kOutside) {
+      safety = std::min(safety, solid->DistanceToIn(daughterPoint));
+    } else {
+      // The point is in this daughter: the other daughters are all farther
+      // than its boundary (no overlaps) so continue one level down.
+      safety = std::min(safety, solid->DistanceToOut(daughterPoint));
+      return LocateInLogVol(pvol->GetLogicalVolume(), daughterPoint, safety);
+    }
+  }
+  return lvol;
+}
+
+
+G4double G4HepEmWoodcockHelper::GetRandom(G4HepEmRandomEngine* rnge) {
+  if (fRandomIndex == kRandomBufferSize) {
+    rnge->flatArray(kRandomBufferSize, fRandomBuffer);
+    fRandomIndex = 0;
+  }
+  return fRandomBuffer[fRandomIndex++];
+}
+
+
+G4double G4HepEmWoodcockHelper::GetMajorantMXsec(const G4double* majorant, G4double ekin) const {
+  // piecewise constant: the maximum within each bin is stored (see `BuildMajorantMXsec`)
+  const G4int ilow = (G4int)((G4HepEmLog(ekin)-fMajorantLogEMin)*fMajorantInvLogDelta);
+  return majorant[std::min(std::max(ilow, 0), fMajorantNumEnergies-2)];
+}
+
+
+G4bool G4HepEmWoodcockHelper::BuildRootMajorantMXsec(G4LogicalVolume* rootLogVol, G4Region* region,
+                                                     const struct G4HepEmData* hepEmData,
+                                                     std::vector<G4double>& majorant) {
+  std::vector<G4int> hepEmIMCs;
+  std::vector<WDTExclusionZone> exclusionZones;
+  if (!FindWDTMatCuts(rootLogVol, region, hepEmData->fTheMatCutData, hepEmIMCs,
+                      G4AffineTransform(), true, exclusionZones)) {
+    majorant.clear();
+    return false;
+  }
+  BuildMajorantMXsec(hepEmData, hepEmIMCs, majorant);
+  return true;
+}
+
+
+void G4HepEmWoodcockHelper::BuildMajorantMXsec(const struct G4HepEmData* hepEmData, const std::vector<G4int>& hepEmIMCs, std::vector<G4double>& majorant) const {
+  // compute the maximum total mac. xsec over the couples at each grid energy
+  std::vector<G4double> maxMXsec(fMajorantNumEnergies, 0.0);
+  G4HepEmGammaTrack aGammaTrack;
+  G4HepEmTrack* aTrack = aGammaTrack.GetTrack();
+  for (G4int ie=0; ie<fMajorantNumEnergies; ++ie) {
+    const G4double logEkin = fMajorantLogEMin + ie/fMajorantInvLogDelta;
+    for (const G4int hepEmIMC : hepEmIMCs) {
+      aTrack->SetEKin(G4HepEmExp(logEkin), logEkin);
+      aTrack->SetMCIndex(hepEmIMC);
+      maxMXsec[ie] = std::max(maxMXsec[ie], G4HepEmGammaManager::GetTotalMacXSec(hepEmData, &aGammaTrack));
+    }
+  }
+  // The maximum of the bin edge values is stored for each bin (piecewise constant).
+  majorant.resize(fMajorantNumEnergies-1);
+  for (G4int ie=0; ie<fMajorantNumEnergies-1; ++ie) {
+    majorant[ie] = std::max(maxMXsec[ie], maxMXsec[ie+1]);
+  }
+  // However, the total cross section can have local maxima inside the bins:
+  //  - at the absorption (e.g. K-shell) edges below the 2nd gamma energy window,
+  //    where the PE cross section is given by the Sandia parametrisation that
+  //    jumps up at the start of each of its intervals,
+  //  - at the nodes of the tables of the Compton (1st window) and total (2nd
+  //    window) cross sections that are linearly interpolated (in log energy).
+  // Between these points the cross section has no local maximum, so they are
+  // also evaluated (at the start of the Sandia intervals, i.e. just above the
+  // edges) and folded into the maximum of the bin they fall into.
+  const G4HepEmGammaData* gmData = hepEmData->fTheGammaData;
+  std::vector<G4double> ekins;
+  for (G4int i=0; i<gmData->fEGridSize0; ++i) {
+    ekins.push_back(G4HepEmExp(gmData->fLogEMin0 + i/gmData->fEILDelta0));
+  }
+  for (G4int i=0; i<gmData->fEGridSize1; ++i) {
+    ekins.push_back(G4HepEmExp(gmData->fLogEMin1 + i/gmData->fEILDelta1));
+  }
+  for (const G4int hepEmIMC : hepEmIMCs) {
+    const G4int imat = hepEmData->fTheMatCutData->fMatCutData[hepEmIMC].fHepEmMatIndex;
+    const G4HepEmMatData& matData = hepEmData->fTheMaterialData->fMaterialData[imat];
+    ekins.insert(ekins.end(), matData.fSandiaEnergies, matData.fSandiaEnergies + matData.fNumOfSandiaIntervals);
+  }
+  for (const G4double ekin : ekins) {
+    // the same bin as in `GetMajorantMXsec` (energies below the grid use the first bin)
+    const G4double logEkin = G4HepEmLog(ekin);
+    const G4int ibin = std::max((G4int)((logEkin-fMajorantLogEMin)*fMajorantInvLogDelta), 0);
+    if (ibin > fMajorantNumEnergies-2) {
+      continue;
+    }
+    for (const G4int hepEmIMC : hepEmIMCs) {
+      aTrack->SetEKin(ekin, logEkin);
+      aTrack->SetMCIndex(hepEmIMC);
+      majorant[ibin] = std::max(majorant[ibin], G4HepEmGammaManager::GetTotalMacXSec(hepEmData, &aGammaTrack));
+    }
+  }
+}
+
+
+G4bool G4HepEmWoodcockHelper::FindWDTMatCuts(G4LogicalVolume* lvol, G4Region* region, const struct G4HepEmMatCutData* hepEmMatCutData, std::vector<G4int>& hepEmIMCs,
+                                           const G4AffineTransform& rootToLocal, G4bool isNormalPath, std::vector<WDTExclusionZone>& exclusionZones) {
+  const G4MaterialCutsCouple* couple = region->FindCouple(lvol->GetMaterial());
+  const G4int hepEmIMC = hepEmMatCutData->fG4MCIndexToHepEmMCIndex[couple->GetIndex()];
+  if (std::find(hepEmIMCs.begin(), hepEmIMCs.end(), hepEmIMC) == hepEmIMCs.end()) {
+    hepEmIMCs.push_back(hepEmIMC);
   }
   // recurse
   int numDaughters = lvol->GetNoDaughters();
   for (int id=0; id<numDaughters; ++id) {
-      G4LogicalVolume* lv = lvol->GetDaughter(id)->GetLogicalVolume();
-      // detect sub-region and stop if found: Woodcock tracking can be used only in leaf regions
+      G4VPhysicalVolume* pv = lvol->GetDaughter(id);
+      G4LogicalVolume*   lv = pv->GetLogicalVolume();
+      const G4bool isNormal = isNormalPath && pv->VolumeType() == kNormal;
+      // transformation from the root to the daughter local frame
+      G4AffineTransform rootToDaughter;
+      if (isNormal) {
+        rootToDaughter.InverseProduct(rootToLocal, G4AffineTransform(pv->GetRotation(), pv->GetTranslation()));
+      }
+      // detect sub-region: its volume is excluded from Woodcock tracking
       if (lvol->GetRegion() != lv->GetRegion()) {
-        std::cerr << "\n *** G4HepEmWoodcockHelper::FindWDTMaterial \n"
-                  << "     Woodcock tracking cannot be applied in this region: " << lvol->GetRegion()->GetName() << "\n"
-                  << "     A sub-region has been found: " <<  lv->GetRegion()->GetName() << "\n"
-                  << "     Note: Woodcock tracking requires leaf region!\n"
-                  << std::endl;
-        exit(1);
+        // the placement of the sub-region volume needs to be unique
+        if (!isNormal) {
+          std::cerr << "\n *** G4HepEmWoodcockHelper::FindWDTMatCuts \n"
+                    << "     Woodcock tracking cannot be applied in this region: " << lvol->GetRegion()->GetName() << "\n"
+                    << "     A sub-region has been found: " <<  lv->GetRegion()->GetName() << "\n"
+                    << "     Note: sub-region volumes are supported only as normal placements\n"
+                    << "           (not within or as replica or parameterised volumes)!\n";
+          return false;
+        }
+        exclusionZones.push_back({lv->GetSolid(), rootToDaughter});
+        continue;
+      }
+      if (!FindWDTMatCuts(lv, region, hepEmMatCutData, hepEmIMCs, rootToDaughter, isNormal, exclusionZones)) {
+        return false;
       }
-      FindWDTMaterial(lv, maxDensity, maxDensityMat);
   }
+  return true;
+}
+
+
+G4double G4HepEmWoodcockHelper::DistanceToBoundary(const G4ThreeVector& localPoint, const G4ThreeVector& localDirection) const {
+  G4double dist = fWDTSolid->DistanceToOut(localPoint, localDirection);
+  for (const WDTExclusionZone& zone : *fWDTExclusionZones) {
+    const G4ThreeVector zonePoint = zone.fTransform.TransformPoint(localPoint);
+    const G4ThreeVector zoneDir   = zone.fTransform.TransformAxis(localDirection);
+    dist = std::min(dist, zone.fSolid->DistanceToIn(zonePoint, zoneDir));
+  }
+  return dist;
 }
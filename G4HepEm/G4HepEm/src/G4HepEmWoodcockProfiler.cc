@@ -0,0 +1,129 @@
+
+#include "G4HepEmWoodcockProfiler.hh"
+#include "G4HepEmWoodcockHelper.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4NavigationHistory.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4TouchableHistory.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <algorithm>
+#include <iomanip>
+
+G4HepEmWoodcockProfiler::G4HepEmWoodcockProfiler(bool isMaster, const struct G4HepEmData* hepEmData, double ekinLimit)
+: G4HepEmSharedAccumulator(isMaster), fEKinLimit(ekinLimit), fWDTHelper(new G4HepEmWoodcockHelper) {
+  // The majorant tables are built on the same energy grid as for Woodcock tracking
+  fWDTHelper->SetKineticEnergyLimit(ekinLimit);
+  // Collect all root logical volumes of all regions (same order in all threads)
+  int maxLogVolID = -1;
+  for (const G4LogicalVolume* lvol : *G4LogicalVolumeStore::GetInstance()) {
+    maxLogVolID = std::max(maxLogVolID, lvol->GetInstanceID());
+  }
+  fRootIndexPerLogVol.assign(maxLogVolID+1, -1);
+  for (G4Region* region : *G4RegionStore::GetInstance()) {
+    std::vector<G4LogicalVolume*>::const_iterator itrLV = region->GetRootLogicalVolumeIterator();
+    const std::size_t numRootLVolume = region->GetNumberOfRootVolumes();
+    for (std::size_t ilv=0; ilv<numRootLVolume; ++ilv, ++itrLV) {
+      const G4LogicalVolume* rootLogVol = *itrLV;
+      fRootIndexPerLogVol[rootLogVol->GetInstanceID()] = fRootNames.size();
+      fRegionNames.push_back(region->GetName());
+      fRootNames.push_back(rootLogVol->GetName());
+      fRootMajorantMXsec.emplace_back();
+      fWDTHelper->BuildRootMajorantMXsec(*itrLV, region, hepEmData, fRootMajorantMXsec.back());
+    }
+  }
+  InitSharedAccumulator(fRootNames.size()*kNumQuantities, "G4HepEmWoodcockProfiler");
+}
+
+
+G4HepEmWoodcockProfiler::~G4HepEmWoodcockProfiler() {}
+
+
+void G4HepEmWoodcockProfiler::RecordStep(const G4Track& track, double ekin, double mxsec,
+                                         double stepLength, bool isGeomLimited) {
+  if (ekin < fEKinLimit) {
+    return;
+  }
+  // Find the root logical volume in which this step is done
+  const G4NavigationHistory* navHistory = ((G4TouchableHistory*)(track.GetTouchableHandle()()))->GetHistory();
+  const int numLogVols = fRootIndexPerLogVol.size();
+  int indxRoot = -1;
+  for (int depth = navHistory->GetDepth(); depth > -1 && indxRoot < 0; --depth) {
+    const int logVolID = navHistory->GetVolume(depth)->GetLogicalVolume()->GetInstanceID();
+    indxRoot = logVolID < numLogVols ? fRootIndexPerLogVol[logVolID] : -1;
+  }
+  // the roots that cannot be Woodcock tracked have no majorant
+  if (indxRoot < 0 || fRootMajorantMXsec[indxRoot].empty()) {
+    return;
+  }
+  double* data = &fLocalData[indxRoot*kNumQuantities];
+  if (isGeomLimited) {
+    data[kNumGeomSteps]      += 1.0;
+    data[kSumGeomStepLength] += stepLength;
+  } else {
+    data[kNumPhysSteps]      += 1.0;
+    data[kSumPhysStepLength] += stepLength;
+  }
+  data[kSumRealMFPs]     += mxsec*stepLength;
+  data[kSumMajorantMFPs] += fWDTHelper->GetMajorantMXsec(fRootMajorantMXsec[indxRoot].data(), ekin)*stepLength;
+}
+
+
+void G4HepEmWoodcockProfiler::Report(std::ostream& os) const {
+  if (!IsMaster()) {
+    return;
+  }
+  // Estimate the number of saved navigation calls for each root: Woodcock
+  // tracking removes the geometry limited steps while one point location is
+  // needed at each delta interaction.
+  const int numRoots = fRootNames.size();
+  std::vector<int>    indices;
+  std::vector<double> saved(numRoots, 0.0);
+  for (int ir=0; ir<numRoots; ++ir) {
+    const int indx = ir*kNumQuantities;
+    const double numSteps = GetSharedData(indx + kNumGeomSteps) + GetSharedData(indx + kNumPhysSteps);
+    if (numSteps > 0.0) {
+      const double numDelta = std::max(0.0, GetSharedData(indx + kSumMajorantMFPs) - GetSharedData(indx + kSumRealMFPs));
+      saved[ir] = GetSharedData(indx + kNumGeomSteps) - numDelta;
+      indices.push_back(ir);
+    }
+  }
+  std::sort(indices.begin(), indices.end(), [&saved](int a, int b) { return saved[a] > saved[b]; });
+  os << "\n ===================================================================================================== \n"
+     << "  G4HepEm Woodcock tracking profiler: ranked list of regions (root logical volumes) where Woodcock \n"
+     << "  tracking would most reduce the number of navigation calls (photon steps above " << fEKinLimit << " [MeV]) \n"
+     << " ===================================================================================================== \n";
+  os << std::left  << std::setw(24) << " Region" << std::setw(24) << " Root logical volume"
+     << std::right << std::setw(12) << "#geom-steps" << std::setw(12) << "#phys-steps"
+     << std::setw(12) << "<L_geom>" << std::setw(12) << "<L_phys>"
+     << std::setw(10) << "maj/real" << std::setw(12) << "#delta" << std::setw(12) << "#saved"
+     << std::endl;
+  for (const int ir : indices) {
+    const int indx = ir*kNumQuantities;
+    const double numGeom  = GetSharedData(indx + kNumGeomSteps);
+    const double numPhys  = GetSharedData(indx + kNumPhysSteps);
+    const double realMFPs = GetSharedData(indx + kSumRealMFPs);
+    const double majMFPs  = GetSharedData(indx + kSumMajorantMFPs);
+    os << std::left  << " " << std::setw(23) << fRegionNames[ir].substr(0, 22)
+       << " " << std::setw(23) << fRootNames[ir].substr(0, 22)
+       << std::right << std::setw(12) << std::fixed << std::setprecision(0) << numGeom
+       << std::setw(12) << numPhys
+       << std::setw(12) << std::setprecision(3) << (numGeom > 0.0 ? GetSharedData(indx + kSumGeomStepLength)/numGeom : 0.0)
+       << std::setw(12) << (numPhys > 0.0 ? GetSharedData(indx + kSumPhysStepLength)/numPhys : 0.0)
+       << std::setw(10) << std::setprecision(2) << (realMFPs > 0.0 ? majMFPs/realMFPs : 0.0)
+       << std::setw(12) << std::setprecision(0) << std::max(0.0, majMFPs - realMFPs)
+       << std::setw(12) << saved[ir]
+       << std::endl;
+  }
+  os << std::defaultfloat
+     << "  <L_geom>, <L_phys>: average geometry and physics limited step lengths [mm] \n"
+     << "  maj/real: ratio of the majorant and real number of mean free paths travelled \n"
+     << "  #delta  : estimated number of delta interactions (point locations) with Woodcock tracking \n"
+     << "  #saved  : estimated number of saved navigation calls (#geom-steps - #delta) \n"
+     << " ===================================================================================================== \n"
+     << std::endl;
+}
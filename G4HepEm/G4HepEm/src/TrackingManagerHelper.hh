@@ -37,12 +37,16 @@
 #ifndef TrackingManagerHelper_hh
 #define TrackingManagerHelper_hh 1
 
+#include "G4AffineTransform.hh"
 #include "G4ThreeVector.hh"
 #include "G4TrackVector.hh"
 #include "globals.hh"
 
 class G4Step;
 class G4Track;
+class G4VPhysicalVolume;
+class G4VSolid;
+class G4VTouchable;
 
 class G4Navigator;
 class G4PropagatorInField;
@@ -90,6 +94,31 @@ class TrackingManagerHelper
     }
   };
 
+  // Cache of the current volume of the track if it's a daughterless (leaf),
+  // normal placement: the distance to its boundary and the safety can then be
+  // computed directly by its solid (in the local frame) instead of the navigator.
+  class LeafVolume
+  {
+   public:
+    // Updates the cache (only if the touchable changed) and returns true if
+    // the current volume is a daughterless, normal placement.
+    inline G4bool Update(const G4Track& track);
+    // Distance to out and safety of the given global point (and direction).
+    inline G4double DistanceToOut(const G4ThreeVector& pos,
+                                  const G4ThreeVector& dir) const;
+    inline G4double Safety(const G4ThreeVector& pos) const;
+    // Invalidates the cache: needs to be called whenever a new touchable is
+    // installed as the touchables are pool allocated, i.e. a new one might
+    // reuse the address of the previous one.
+    void Invalidate() { fTouchable = nullptr; }
+
+   private:
+    const G4VTouchable* fTouchable = nullptr;
+    const G4VSolid* fSolid         = nullptr;
+    G4AffineTransform fToLocal;
+    G4bool fIsLeaf = false;
+  };
+
   class Navigation
   {
    public:
@@ -107,6 +136,10 @@ class TrackingManagerHelper
                              G4double physicalStep) override;
     inline void FinishStep(G4Track& track, G4Step& step) override;
 
+    // Use the solid of daughterless volumes directly (instead of the navigator)
+    // for linear steps that do not leave the volume (false by default).
+    void SetLeafVolumeShortcut(G4bool val) { fIsLeafVolumeShortcut = val; }
+
    private:
     G4Navigator* fLinearNavigator;
     G4PropagatorInField* fFieldPropagator;
@@ -116,6 +149,8 @@ class TrackingManagerHelper
     G4double fPostStepSafety = 0;
     G4double kCarTolerance;
     G4bool fGeometryLimitedStep;
+    G4bool fIsLeafVolumeShortcut = false;
+    LeafVolume fLeafVolume;
   };
 
   class NeutralNavigation final : public Navigation
@@ -126,6 +161,13 @@ class TrackingManagerHelper
                              G4double physicalStep) override;
     inline void FinishStep(G4Track& track, G4Step& step) override;
 
+    // Use the solid of daughterless volumes directly (instead of the navigator)
+    // for steps that do not leave the volume (false by default).
+    void SetLeafVolumeShortcut(G4bool val) { fIsLeafVolumeShortcut = val; }
+    // Needs to be called when the touchable of the track is changed outside
+    // the navigation (e.g. by the Woodcock tracking).
+    void InvalidateLeafVolume() { fLeafVolume.Invalidate(); }
+
    private:
     G4Navigator* fLinearNavigator;
     G4SafetyHelper* fSafetyHelper;
@@ -134,6 +176,8 @@ class TrackingManagerHelper
     G4double fPostStepSafety = 0;
     G4double kCarTolerance;
     G4bool fGeometryLimitedStep;
+    G4bool fIsLeafVolumeShortcut = false;
+    LeafVolume fLeafVolume;
   };
 
   template <typename PhysicsImpl, typename NavigationImpl>
@@ -46,6 +46,31 @@ struct G4HepEmRegionParmeters {
 
   /** Apply secondary production threshold on all interactions (beyond ioni. and brem.) */
   bool   fIsApplyCuts = true;
+
+  /** \f$e^-/e^+\f$ tracking (kinetic) energy cut in the region: \f$e^-/e^+\f$ tracks are stopped
+    * when their energy drops below this threshold (the global `fElectronTrackingCut` by default).*/
+  double fElectronTrackingCut = 0.001;
+  /** \f$\gamma\f$ kill (kinetic) energy threshold in the region: \f$\gamma\f$ tracks (as well as
+    * secondary \f$\gamma\f$-s) below this threshold are killed and their energy is deposited
+    * locally (zero by default, i.e. inactive).*/
+  double fGammaTrackingCut = 0.0;
+
+  /** Weight window (importance) of the region: tracks entering the region with weight above the upper
+    * bound are split while those below the lower bound are rouletted (surviving with the survival weight).
+    * Inactive when the lower bound is not positive (default).*/
+  double fWeightWindowLower    = 0.0;
+  double fWeightWindowUpper    = 0.0;
+  double fWeightWindowSurvival = 0.0;
+
+  /** Number of photons emitted in each bremsstrahlung interaction (uniform brem splitting): each
+    * photon has 1/N (relative) weight while the primary energy loss is sampled once (1 by default,
+    * i.e. no splitting).*/
+  int    fBremSplittingNum = 1;
+
+  /** Leading particle biasing: after brem, ionisation, Compton and conversion the most energetic
+    * product is always kept while the others are kept with probability proportional to their energy
+    * (with their weight increased accordingly). False by default.*/
+  bool   fIsLeadingParticleBiasing = false;
 };
 
 
@@ -137,6 +137,17 @@ namespace nlohmann
       j["fIsELossFluctuation"]        = d.fIsELossFluctuation;
       j["fIsMultipleStepsInMSCTrans"] = d.fIsMultipleStepsInMSCTrans;
       j["fIsApplyCuts"]               = d.fIsApplyCuts;
+
+      j["fElectronTrackingCut"] = d.fElectronTrackingCut;
+      j["fGammaTrackingCut"]    = d.fGammaTrackingCut;
+
+      j["fWeightWindowLower"]    = d.fWeightWindowLower;
+      j["fWeightWindowUpper"]    = d.fWeightWindowUpper;
+      j["fWeightWindowSurvival"] = d.fWeightWindowSurvival;
+
+      j["fBremSplittingNum"] = d.fBremSplittingNum;
+
+      j["fIsLeadingParticleBiasing"] = d.fIsLeadingParticleBiasing;
     }
 
     static G4HepEmRegionParmeters from_json(const json& j)
@@ -155,6 +166,20 @@ namespace nlohmann
       j.at("fIsMultipleStepsInMSCTrans").get_to(d.fIsMultipleStepsInMSCTrans);
       j.at("fIsApplyCuts").get_to(d.fIsApplyCuts);
 
+      // the regional tracking cuts might be missing from older files: the
+      // e- cut is set to the global one then by the `G4HepEmParameters` reader
+      d.fElectronTrackingCut = j.value("fElectronTrackingCut", d.fElectronTrackingCut);
+      d.fGammaTrackingCut    = j.value("fGammaTrackingCut", d.fGammaTrackingCut);
+
+      // optional (missing from older files): inactive by default
+      d.fWeightWindowLower    = j.value("fWeightWindowLower", d.fWeightWindowLower);
+      d.fWeightWindowUpper    = j.value("fWeightWindowUpper", d.fWeightWindowUpper);
+      d.fWeightWindowSurvival = j.value("fWeightWindowSurvival", d.fWeightWindowSurvival);
+
+      d.fBremSplittingNum = j.value("fBremSplittingNum", d.fBremSplittingNum);
+
+      d.fIsLeadingParticleBiasing = j.value("fIsLeadingParticleBiasing", d.fIsLeadingParticleBiasing);
+
       return d;
     }
   };
@@ -207,6 +232,14 @@ namespace nlohmann
         d->fParametersPerRegion  = new G4HepEmRegionParmeters[d->fNumRegions];
         auto tmpParPerRegion = j.at("fParametersPerRegion");
         std::copy(tmpParPerRegion.begin(), tmpParPerRegion.end(), d->fParametersPerRegion);
+        // files written before the regional e- tracking cut: use the global one
+        for(int i = 0; i < d->fNumRegions; ++i)
+        {
+          if(!tmpParPerRegion[i].contains("fElectronTrackingCut"))
+          {
+            d->fParametersPerRegion[i].fElectronTrackingCut = d->fElectronTrackingCut;
+          }
+        }
 
         return d;
       }
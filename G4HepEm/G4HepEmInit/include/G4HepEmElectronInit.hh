@@ -5,10 +5,15 @@
 #ifndef G4HepEmElementInit_HH
 #define G4HepEmElementInit_HH
 
+#include "G4HepEmInitStageHook.hh"
+
 struct G4HepEmData;
 struct G4HepEmParameters;
 
-void InitElectronData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* hepEmPars, bool iselectron, int verbose=0);
+// The optional `stageHook` is invoked with `hookData` at the beginning and end
+// of each stage of the initialisation (see G4HepEmInitStageHook.hh).
+void InitElectronData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* hepEmPars, bool iselectron, int verbose=0,
+                      G4HepEmInitStageHook stageHook=nullptr, void* hookData=nullptr);
 
 
 
@@ -7,10 +7,15 @@
 #ifndef G4HepEmGammaInit_HH
 #define G4HepEmGammaInit_HH
 
+#include "G4HepEmInitStageHook.hh"
+
 struct G4HepEmData;
 struct G4HepEmParameters;
 
-void InitGammaData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* hepEmPars, int verbose=0);
+// The optional `stageHook` is invoked with `hookData` at the beginning and end
+// of each stage of the initialisation (see G4HepEmInitStageHook.hh).
+void InitGammaData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* hepEmPars, int verbose=0,
+                   G4HepEmInitStageHook stageHook=nullptr, void* hookData=nullptr);
 
 
 
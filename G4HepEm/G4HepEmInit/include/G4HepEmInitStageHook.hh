@@ -0,0 +1,16 @@
+
+#ifndef G4HepEmInitStageHook_HH
+#define G4HepEmInitStageHook_HH
+
+//
+// Optional hook of the data initialisation (see `InitElectronData` and
+// `InitGammaData`): invoked at the beginning (`isBegin=true`) and at the end
+// (`isBegin=false`) of each stage of the initialisation with the name of the
+// stage (e.g. "models", "energy loss", "lambda", etc.) and the `userData`
+// given together with the hook. Can be used e.g. to measure the time and
+// memory requirements of the individual stages.
+//
+typedef void (*G4HepEmInitStageHook)(const char* stageName, bool isBegin, void* userData);
+
+
+#endif // G4HepEmInitStageHook_HH
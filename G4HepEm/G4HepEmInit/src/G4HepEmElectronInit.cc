@@ -33,8 +33,16 @@
 #include <iostream>
 
 
+// Invokes the (optional) stage hook.
+static void InvokeStageHook(G4HepEmInitStageHook stageHook, void* hookData, const char* stageName, bool isBegin) {
+  if (stageHook != nullptr) {
+    stageHook(stageName, isBegin, hookData);
+  }
+}
+
+
 void InitElectronData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* hepEmPars,
-                      bool iselectron, int verbose) {
+                      bool iselectron, int verbose, G4HepEmInitStageHook stageHook, void* hookData) {
   // clean previous G4HepEmElectronData (if any)
   //
   // create G4Models for e- or for e+
@@ -43,6 +51,7 @@ void InitElectronData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* h
     g4PartDef = G4Electron::Electron();
   }
   if (verbose > 1) std::cout << "     ---  InitElectronData ... " << std::endl;
+  InvokeStageHook(stageHook, hookData, "models", true);
   // Min/Max energies of the EM model (same as for the loss-tables)
   G4double emModelEMin = G4EmParameters::Instance()->MinKinEnergy();
   G4double emModelEMax = G4EmParameters::Instance()->MaxKinEnergy();
@@ -107,20 +116,29 @@ void InitElectronData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* h
   } else {
     AllocateElectronData(&(hepEmData->fThePositronData));
   }
+  InvokeStageHook(stageHook, hookData, "models", false);
   // build energy loss data
   if (verbose > 1) std::cout << "     ---  BuildELossTables ..." << std::endl;
+  InvokeStageHook(stageHook, hookData, "energy loss", true);
   BuildELossTables(modelMB, modelSB, modelRB, hepEmData, hepEmPars, iselectron);
+  InvokeStageHook(stageHook, hookData, "energy loss", false);
   // build macroscopic cross section data (mat-cut dependent ioni and brem)
   if (verbose > 1) std::cout << "     ---  BuildLambdaTables ... " << std::endl;
+  InvokeStageHook(stageHook, hookData, "lambda", true);
   BuildLambdaTables(modelMB, modelSB, modelRB, hepEmData, hepEmPars, iselectron);
   // build macroscopic cross section data (mat dependent electron -, positron - nuclear)
   BuildNuclearLambdaTables(&hadENucXSDataStore, hepEmData, hepEmPars, iselectron);
+  InvokeStageHook(stageHook, hookData, "lambda", false);
   // build macroscopic first transport cross section data (used by Urban msc)
   if (verbose > 1) std::cout << "     ---  BuildTransportXSectionTables ... " << std::endl;
+  InvokeStageHook(stageHook, hookData, "transport", true);
   BuildTransportXSectionTables(modelUMSC, hepEmData, hepEmPars, iselectron);
+  InvokeStageHook(stageHook, hookData, "transport", false);
   // build element selectors
   if (verbose > 1) std::cout << "     ---  BuildElementSelectorTables ... " << std::endl;
+  InvokeStageHook(stageHook, hookData, "selectors", true);
   BuildElementSelectorTables(modelMB, modelSB, modelRB, hepEmData, hepEmPars, iselectron);
+  InvokeStageHook(stageHook, hookData, "selectors", false);
   //
   // === Initialize the interaction description part of all models
   //
@@ -131,7 +149,9 @@ void InitElectronData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* h
   //       so we should build them only once)
   if (!hepEmData->fTheSBTableData) {
     if (verbose > 1) std::cout << "     ---  BuildSBBremTables ... " << std::endl;
+    InvokeStageHook(stageHook, hookData, "SB tables", true);
     BuildSBBremSTables(hepEmData, hepEmPars, modelSB);
+    InvokeStageHook(stageHook, hookData, "SB tables", false);
   }
 
   // delete all g4 models
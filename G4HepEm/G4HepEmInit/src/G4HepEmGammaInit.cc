@@ -34,12 +34,21 @@
 
 #include <iostream>
 
-void InitGammaData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* /*hepEmPars*/, int verbose) {
+// Invokes the (optional) stage hook.
+static void InvokeStageHook(G4HepEmInitStageHook stageHook, void* hookData, const char* stageName, bool isBegin) {
+  if (stageHook != nullptr) {
+    stageHook(stageName, isBegin, hookData);
+  }
+}
+
+void InitGammaData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* /*hepEmPars*/, int verbose,
+                   G4HepEmInitStageHook stageHook, void* hookData) {
   // clean previous G4HepEmElectronData (if any)
   //
   // create G4Models for gamma
   G4ParticleDefinition* g4PartDef = G4Gamma::Gamma();
   if (verbose > 1) std::cout << "     ---  InitGammaData ... " << std::endl;
+  InvokeStageHook(stageHook, hookData, "models", true);
   // Min/Max energies of the EM model (same as for the loss-tables)
   G4double emModelEMin = G4EmParameters::Instance()->MinKinEnergy();
   G4double emModelEMax = G4EmParameters::Instance()->MaxKinEnergy();
@@ -85,12 +94,17 @@ void InitGammaData(struct G4HepEmData* hepEmData, struct G4HepEmParameters* /*he
   // allocate the GammaData (NOTE: shallow only, BuildLambdaTables will complete
   // the allocation) but cleans the memory of the hepEmData->fTheGammaData
   AllocateGammaData(&(hepEmData->fTheGammaData));
+  InvokeStageHook(stageHook, hookData, "models", false);
   // build macroscopic cross section data for Conversion and Compton
   if (verbose > 1) std::cout << "     ---  BuildLambdaTables ... " << std::endl;
+  InvokeStageHook(stageHook, hookData, "lambda", true);
   BuildLambdaTables(modelPP, modelKN, &hadGNucXSDataStore, hepEmData);
+  InvokeStageHook(stageHook, hookData, "lambda", false);
   // build element selectors
   if (verbose > 1) std::cout << "     ---  BuildElementSelectorTables ... " << std::endl;
+  InvokeStageHook(stageHook, hookData, "selectors", true);
   BuildElementSelectorTables(modelPP, hepEmData);
+  InvokeStageHook(stageHook, hookData, "selectors", false);
   //
   // delete all g4 models
   // NOTE: I don't delete this because something is crashing in G4
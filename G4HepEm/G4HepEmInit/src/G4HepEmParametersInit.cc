@@ -59,5 +59,16 @@ void InitHepEmParameters(struct G4HepEmParameters* hepEmPars) {
     rDat.fIsMultipleStepsInMSCTrans = true;
 
     rDat.fIsApplyCuts = G4EmParameters::Instance()->ApplyCuts();
+
+    rDat.fElectronTrackingCut = hepEmPars->fElectronTrackingCut;
+    rDat.fGammaTrackingCut    = 0.0;
+
+    rDat.fWeightWindowLower    = 0.0;
+    rDat.fWeightWindowUpper    = 0.0;
+    rDat.fWeightWindowSurvival = 0.0;
+
+    rDat.fBremSplittingNum = 1;
+
+    rDat.fIsLeadingParticleBiasing = false;
   }
 }
@@ -25,7 +25,11 @@ private:
   G4HepEmElectronInteractionBrem() = delete;
 
 public:
-  static void Perform(G4HepEmTLData* tlData, struct G4HepEmData* hepEmData, bool iselectron, bool isSBmodel);
+  // `numSplit` > 1 activates (uniform) brem splitting: `numSplit` photons are
+  // emitted, each with 1/`numSplit` (relative) weight, while the primary energy
+  // loss and direction change are sampled only once (from the first photon).
+  static void Perform(G4HepEmTLData* tlData, struct G4HepEmData* hepEmData, bool iselectron, bool isSBmodel,
+                      int numSplit=1);
 
 
   // Sampling of the energy transferred to the emitted photon using the numerical
@@ -0,0 +1,53 @@
+
+#ifndef G4HepEmKernelRecord_HH
+#define G4HepEmKernelRecord_HH
+
+#include <cstdint>
+
+/**
+ * @file    G4HepEmKernelRecord.hh
+ * @struct  G4HepEmKernelRecord
+ * @date    2026
+ *
+ * The binary format of the kernel input records, written by the
+ * `G4HepEmTrackingManager` in its recording mode (see `G4HepEmKernelRecorder`)
+ * and read by the (Geant4 independent) replay tool of the benchmarks.
+ *
+ * A record stream starts with a `G4HepEmKernelRecordHeader` followed by the
+ * fixed size `G4HepEmKernelRecord`-s of the `HowFar` and `Perform` calls (in
+ * the order of the calls). Each record is followed by the 3 `float` components
+ * of the direction if `kIsWithDirection` is set in the header flags. The data
+ * are written in the native byte order (little endian on all supported platforms).
+ */
+
+struct G4HepEmKernelRecordHeader {
+  // flags of the stream
+  static constexpr std::uint32_t kIsWithDirection = 1;
+
+  char          fMagic[8] = {'G', '4', 'H', 'E', 'K', 'R', 'E', 'C'};
+  std::uint32_t fVersion  = 1;
+  std::uint32_t fFlags    = 0;
+};
+
+struct G4HepEmKernelRecord {
+  // kernels
+  static constexpr std::uint8_t kHowFar  = 0;
+  static constexpr std::uint8_t kPerform = 1;
+  // flags
+  static constexpr std::uint8_t kOnBoundary = 1;
+
+  double        fEKin;      // kinetic energy [MeV]
+  float         fSafety;    // pre-step safety [mm] (e-/e+ `HowFar` only)
+  std::int32_t  fHepEmIMC;  // HepEm material-cuts couple index
+  std::int16_t  fRegion;    // region index
+  std::uint8_t  fParticle;  // 0: e-, 1: e+, 2: gamma
+  std::uint8_t  fKernel;    // kHowFar or kPerform
+  std::int8_t   fProcess;   // winner process index (`Perform` only)
+  std::uint8_t  fFlags;     // kOnBoundary
+  std::uint16_t fReserved;
+};
+
+static_assert(sizeof(G4HepEmKernelRecordHeader) == 16, "Unexpected size of G4HepEmKernelRecordHeader");
+static_assert(sizeof(G4HepEmKernelRecord) == 24, "Unexpected size of G4HepEmKernelRecord");
+
+#endif // G4HepEmKernelRecord_HH
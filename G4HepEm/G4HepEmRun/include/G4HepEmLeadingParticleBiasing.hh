@@ -0,0 +1,29 @@
+
+#ifndef G4HepEmLeadingParticleBiasing_HH
+#define G4HepEmLeadingParticleBiasing_HH
+
+class  G4HepEmTLData;
+class  G4HepEmTrack;
+
+// Leading particle biasing applied on the final state of a discrete interaction
+// (brem, ionisation, conversion or Compton) stored in the thread local data.
+// The most energetic product (including the primary if it survived) is always
+// kept while any other is kept with probability `p = E/E_tot` (`E_tot` is the
+// sum of the product energies) and its weight is multiplied by `1/p`. A rejected
+// secondary gets zero (relative) weight and should be ignored while stacking. A
+// rejected primary gets zero kinetic energy (i.e. stopped) and zero weight while
+// the weight of the surviving primary is multiplied by `1/p` (i.e. the weight
+// of the primary `G4HepEmTrack` is the weight factor of the interaction).
+class G4HepEmLeadingParticleBiasing {
+private:
+  G4HepEmLeadingParticleBiasing() = delete;
+
+public:
+  static void Apply(G4HepEmTLData* tlData, G4HepEmTrack* thePrimaryTrack);
+
+private:
+  // Keeps the given (non-leading) product with probability `ekin/eTotal`.
+  static void PlayRoulette(G4HepEmTrack* theTrack, double eTotal, double rand);
+};
+
+#endif // G4HepEmLeadingParticleBiasing_HH
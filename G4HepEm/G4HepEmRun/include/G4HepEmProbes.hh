@@ -0,0 +1,55 @@
+
+#ifndef G4HepEmProbes_HH
+#define G4HepEmProbes_HH
+
+/**
+ * @file    G4HepEmProbes.hh
+ * @date    2026
+ *
+ * User-level statically defined tracing (USDT) probes of the `g4hepem` provider.
+ *
+ * The probes are compiled in only when G4HepEm is built with the
+ * `G4HepEm_USDT_PROBES` CMake option (that requires the `sys/sdt.h` header of
+ * SystemTap, e.g. from the `systemtap-sdt-dev(el)` package) and only into the
+ * host code (i.e. never into the device code). Each probe is a single `nop`
+ * instruction when not traced, while they can be attached to in a running job
+ * by e.g. `perf probe sdt_g4hepem:*` or `bpftrace -e 'usdt:<lib>:g4hepem:* {...}'`.
+ *
+ * All arguments are integers: the kinetic energies are given in [eV] and the
+ * lengths in [nm] (so that they can be used directly in the tracing scripts).
+ * The probes are:
+ *  - `track_start(particleID, trackID, ekin)`, `track_end(particleID, trackID, numSteps)`
+ *    at the start and end of tracking an e-/e+ (`particleID` 0/1) or gamma (2);
+ *  - `step_begin(particleID, trackID, ekin, hepEmIMC)` and
+ *    `step_end(particleID, trackID, stepLength, edep)` around each step;
+ *  - `interaction(particleID, procID, ekin, hepEmIMC)` before each discrete
+ *    interaction performed in the `G4HepEmTrackingManager` (including the ones
+ *    done by the native Geant4 processes);
+ *  - `electron_discrete(procID, ekin, hepEmIMC)` and `gamma_discrete(procID, ekin, hepEmIMC)`
+ *    at the entry of the HepEm discrete interactions (`PerformDiscrete`/`Perform`);
+ *  - `stacking(numSecondaries, numStacked, hepEmIMC)` when the secondaries of
+ *    an interaction are stacked (the others were killed by the cuts or biasing).
+ */
+
+#if defined(G4HepEm_USDT_PROBES) && !defined(__CUDA_ARCH__)
+
+#include <sys/sdt.h>
+
+#define G4HepEmProbe3(name, a1, a2, a3)             DTRACE_PROBE3(g4hepem, name, a1, a2, a3)
+#define G4HepEmProbe4(name, a1, a2, a3, a4)         DTRACE_PROBE4(g4hepem, name, a1, a2, a3, a4)
+
+// Conversions of the energies [MeV] and lengths [mm] to the integer probe arguments.
+#define G4HepEmProbeEnergy(ekin)   static_cast<long long>((ekin)*1.0E+6)
+#define G4HepEmProbeLength(length) static_cast<long long>((length)*1.0E+6)
+
+#else
+
+#define G4HepEmProbe3(name, a1, a2, a3)
+#define G4HepEmProbe4(name, a1, a2, a3, a4)
+
+#define G4HepEmProbeEnergy(ekin)
+#define G4HepEmProbeLength(length)
+
+#endif
+
+#endif // G4HepEmProbes_HH
@@ -7,6 +7,7 @@
 #include "G4HepEmGammaTrack.hh"
 #include "G4HepEmRandomEngine.hh"
 
+#include <algorithm>
 #include <vector>
 
 /**
@@ -56,7 +57,9 @@ public:
     if (fNumSecondaryElectronTracks==fElectronSecondaryTracks.size()) {
       fElectronSecondaryTracks.resize(2*fElectronSecondaryTracks.size());
     }
-    return &(fElectronSecondaryTracks[fNumSecondaryElectronTracks++]);
+    G4HepEmElectronTrack* secTrack = &(fElectronSecondaryTracks[fNumSecondaryElectronTracks++]);
+    secTrack->GetTrack()->SetWeight(1.0);
+    return secTrack;
   }
   std::size_t GetNumSecondaryElectronTrack() { return fNumSecondaryElectronTracks; }
   void        ResetNumSecondaryElectronTrack() { fNumSecondaryElectronTracks = 0; }
@@ -68,7 +71,16 @@ public:
     if (fNumSecondaryGammaTracks==fGammaSecondaryTracks.size()) {
       fGammaSecondaryTracks.resize(2*fGammaSecondaryTracks.size());
     }
-    return &(fGammaSecondaryTracks[fNumSecondaryGammaTracks++]);
+    G4HepEmGammaTrack* secTrack = &(fGammaSecondaryTracks[fNumSecondaryGammaTracks++]);
+    secTrack->GetTrack()->SetWeight(1.0);
+    return secTrack;
+  }
+  // Makes sure that `num` more secondary gamma tracks can be added without
+  // reallocation (e.g. before brem splitting)
+  void ReserveSecondaryGammaTracks(std::size_t num) {
+    if (fNumSecondaryGammaTracks+num > fGammaSecondaryTracks.size()) {
+      fGammaSecondaryTracks.resize(std::max(2*fGammaSecondaryTracks.size(), fNumSecondaryGammaTracks+num));
+    }
   }
   std::size_t GetNumSecondaryGammaTrack() { return fNumSecondaryGammaTracks; }
   void        ResetNumSecondaryGammaTrack() { fNumSecondaryGammaTracks = 0; }
@@ -53,6 +53,8 @@ public:
 
     fSafety       = o.fSafety;
 
+    fWeight       = o.fWeight;
+
     fID           = o.fID;
     fIDParent     = o.fIDParent;
 
@@ -169,6 +171,12 @@ public:
   G4HepEmHostDevice
   double  GetSafety() const   { return fSafety; }
 
+  // Weight (relative to the parent in case of secondaries, e.g. brem splitting)
+  G4HepEmHostDevice
+  void    SetWeight(double w) { fWeight = w; }
+  G4HepEmHostDevice
+  double  GetWeight() const   { return fWeight; }
+
 
   // ID
   G4HepEmHostDevice
@@ -229,6 +237,8 @@ public:
     fNumIALeft[2] = -1.0;
     fNumIALeft[3] = -1.0;
 
+    fWeight       =  1.0;
+
     fID           =  -1;
     fIDParent     =  -1;
 
@@ -253,6 +263,7 @@ private:
   double   fMFPs[4];       // pair, compton, photo-electric, gamma-nuclear in case of photon
   double   fNumIALeft[4];  // ioni, brem, (e+-e- annihilation) in case of e- (e+)
   double   fSafety;
+  double   fWeight;
 
   int      fID;
   int      fIDParent;
@@ -0,0 +1,24 @@
+#ifndef G4HepEmWeightWindow_HH
+#define G4HepEmWeightWindow_HH
+
+// Weight window applied on the tracks entering a region (see the weight window
+// fields of `G4HepEmRegionParmeters`): tracks with weight below the lower bound
+// play Russian roulette while those above the upper bound are split. Both keep
+// the expected weight, the roulette provided that `weight <= survival` that is
+// ensured by requiring `lower <= survival` (see `G4HepEmConfig::SetWeightWindow`).
+class G4HepEmWeightWindow {
+private:
+  G4HepEmWeightWindow() = delete;
+
+public:
+  // Russian roulette: the track survives with `weight/survival` probability and
+  // gets `survival` weight. Returns the new weight (zero if the track is killed).
+  static double PlayRoulette(double weight, double survival, double rand);
+
+  // Splitting: the number of tracks (including the original one) the track with
+  // `weight` above `upper` is split into, each with `weight/numSplit` weight (at
+  // most `maxNumSplit`).
+  static int GetNumSplit(double weight, double upper, int maxNumSplit);
+};
+
+#endif // G4HepEmWeightWindow_HH
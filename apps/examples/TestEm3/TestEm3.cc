@@ -55,26 +55,54 @@
 #include "PhysicsList.hh"
 #include "ActionInitialization.hh"
 #include "SteppingVerbose.hh"
+#include "BenchmarkComparison.hh"
 
 
 #include <getopt.h>
 #include <err.h>
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+
+#include <unistd.h>
+#include <sys/wait.h>
 
 
 
 
 static bool isPerformance = false;
 static std::string  macrofile="";
+// benchmark mode: physics lists, number of threads and the JSON summary file
+static bool isBenchmark = false;
+static std::vector<std::string> benchPhysics;
+static std::vector<std::string> benchThreads;
+static std::string  benchJSONFile="";
+// A/B comparison mode of the benchmark (the two physics are in `benchPhysics`)
+static bool isABComparison = false;
+// prefix of the per-event observables files (of the benchmark mode)
+static std::string  benchObsPrefix="";
 
 static struct option options[] = {
    {"flag to run the application in performance mode (default FALSE)", no_argument, 0, 'p'},
    {"standard Geant4 macro file", required_argument, 0, 'm'},
+   {"benchmark mode: comma separated list of physics (e.g. HepEmTracking,G4EmTracking,G4Em)", required_argument, 0, 'b'},
+   {"benchmark mode: comma separated list of number of threads (e.g. 1,2,4,8)", required_argument, 0, 't'},
+   {"benchmark mode: JSON summary file", required_argument, 0, 'j'},
+   {"A/B comparison mode: the two physics to compare (e.g. HepEmTracking,G4EmTracking)", required_argument, 0, 'a'},
+   {"benchmark mode: prefix of the per-event observables files", required_argument, 0, 'o'},
    {0, 0, 0, 0}
  };
 
 void help();
+int  RunApplication(const std::string& physics, const std::string& benchFile, const std::string& obsFile);
+int  RunBenchmark();
+std::vector<std::string> SplitList(const std::string& list);
+double SteadyTime();
 
 
 // ============================================================================
@@ -87,7 +115,7 @@ int main(int argc,char** argv) {
   }
   while (true) {
     int c, optidx = 0;
-    c = getopt_long(argc, argv, "pm:", options, &optidx);
+    c = getopt_long(argc, argv, "pm:b:t:j:a:o:", options, &optidx);
     if (c == -1)
       break;
     //
@@ -101,12 +129,53 @@ int main(int argc,char** argv) {
     case 'm':
       macrofile = optarg;
       break;
+    case 'b':
+      isBenchmark  = true;
+      benchPhysics = SplitList(optarg);
+      break;
+    case 't':
+      isBenchmark  = true;
+      benchThreads = SplitList(optarg);
+      break;
+    case 'j':
+      isBenchmark   = true;
+      benchJSONFile = optarg;
+      break;
+    case 'a':
+      isBenchmark    = true;
+      isABComparison = true;
+      benchPhysics   = SplitList(optarg);
+      if (benchPhysics.size() != 2) {
+        help();
+        errx(1, "exactly two physics are required for the A/B comparison");
+      }
+      break;
+    case 'o':
+      isBenchmark    = true;
+      benchObsPrefix = optarg;
+      break;
     default:
       help();
       errx(1, "unknown option %c", c);
     }
   }
   //
+  // the benchmark mode runs the application for each physics and number of
+  // threads (in separate processes)
+  if (isBenchmark) {
+    return RunBenchmark();
+  }
+  return RunApplication("", "", "");
+}
+
+
+// =============================================================================
+// Runs the application with the macro file: with the given, forced physics and
+// in benchmark mode (the results are appended to `benchFile`) if requested. The
+// per-event observables are also collected and written into `obsFile` if given.
+int RunApplication(const std::string& physics, const std::string& benchFile, const std::string& obsFile) {
+  const double startTime = SteadyTime();
+  //
   // set the RNG seed and custom stepping verbose
   G4Random::setTheSeed(12345678);
   G4VSteppingVerbose::SetInstance(new SteppingVerbose);
@@ -124,10 +193,19 @@ int main(int argc,char** argv) {
   // set mandatory initialization classes
   DetectorConstruction* detector = new DetectorConstruction();
   runManager->SetUserInitialization(detector);
-  runManager->SetUserInitialization(new PhysicsList);
+  PhysicsList* physicsList = new PhysicsList;
+  if (!physics.empty()) {
+    physicsList->ForcePhysicsList(physics);
+  }
+  runManager->SetUserInitialization(physicsList);
 
   // set user action classes
-  runManager->SetUserInitialization(new ActionInitialization(detector,isPerformance));
+  ActionInitialization* actionInit = new ActionInitialization(detector,isPerformance);
+  if (isBenchmark) {
+    actionInit->SetBenchmarkMode(benchFile, startTime);
+    actionInit->SetObservablesFile(obsFile);
+  }
+  runManager->SetUserInitialization(actionInit);
 
   // get the pointer to the User Interface manager
   G4UImanager* UI = G4UImanager::GetUIpointer();
@@ -141,6 +219,131 @@ int main(int argc,char** argv) {
 }
 
 
+// =============================================================================
+// Runs the application (in a child process) for each of the requested physics
+// and number of threads: the number of threads is forced through the
+// `G4FORCENUMBEROFTHREADS` environment variable while the physics through the
+// `PhysicsList::ForcePhysicsList` (i.e. the corresponding macro commands are
+// ignored). The results of the runs are collected into the JSON summary file.
+//
+// The per-event observables (energy deposit, leakage, track and step
+// multiplicities) of each run are written into `<prefix>.<physics>.t<threads>.obs`
+// files if the prefix is given (e.g. for the physics regression tests).
+//
+// In the A/B comparison mode, the two physics are run with the same geometry,
+// primaries and seeds (i.e. as given in the macro) and their per-event
+// observables are always written (the prefix is the JSON summary file name or
+// `TestEm3` if not given). These are then compared by KS tests, together with
+// the throughput per region and particle.
+int RunBenchmark() {
+  if (benchPhysics.empty()) {
+    benchPhysics.push_back("");  // as in the macro
+  }
+  if (benchThreads.empty()) {
+    benchThreads.push_back("");  // as in the macro
+  }
+#ifndef G4MULTITHREADED
+  if (benchThreads.size() > 1 || !benchThreads[0].empty()) {
+    std::cout << " *** WARNING in TestEm3: the number of threads is ignored in sequential mode" << std::endl;
+    benchThreads.assign(1, "");
+  }
+#endif
+  const std::string runsFile = benchJSONFile.empty() ? "" : benchJSONFile + ".runs";
+  if (!runsFile.empty()) {
+    std::remove(runsFile.c_str());
+  }
+  if (benchObsPrefix.empty() && isABComparison) {
+    benchObsPrefix = benchJSONFile.empty() ? "TestEm3" : benchJSONFile;
+  }
+  auto obsFileName = [&](const std::string& physics, const std::string& threads) {
+    if (benchObsPrefix.empty()) {
+      return std::string();
+    }
+    return benchObsPrefix + "." + (physics.empty() ? "macro" : physics) + ".t"
+           + (threads.empty() ? "macro" : threads) + ".obs";
+  };
+  int numFailed = 0;
+  for (const std::string& physics : benchPhysics) {
+    for (const std::string& threads : benchThreads) {
+      std::cout << "\n === TestEm3 benchmark: physics = " << (physics.empty() ? "(macro)" : physics)
+                << ", threads = " << (threads.empty() ? "(macro)" : threads) << std::endl;
+      std::cout.flush();
+      const pid_t pid = fork();
+      if (pid < 0) {
+        errx(1, "cannot fork the benchmark process");
+      }
+      if (pid == 0) {
+        if (!threads.empty()) {
+          setenv("G4FORCENUMBEROFTHREADS", threads.c_str(), 1);
+        }
+        exit(RunApplication(physics, runsFile, obsFileName(physics, threads)));
+      }
+      int status = 0;
+      waitpid(pid, &status, 0);
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << " *** ERROR in TestEm3: the benchmark run failed (physics = " << physics
+                  << ", threads = " << threads << ")" << std::endl;
+        ++numFailed;
+      }
+    }
+  }
+  // write the JSON summary (the runs are written by the `RunAction`-s)
+  if (!runsFile.empty()) {
+    std::ifstream in(runsFile);
+    std::stringstream runs;
+    runs << in.rdbuf();
+    std::string runsStr = runs.str();
+    // remove the separator after the last run
+    const std::size_t last = runsStr.find_last_of(',');
+    if (last != std::string::npos) {
+      runsStr.erase(last);
+    }
+    std::ofstream out(benchJSONFile);
+    out << "{\n  \"application\": \"TestEm3\",\n  \"macro\": \"" << macrofile << "\",\n"
+        << "  \"runs\": [\n" << runsStr << "\n  ]\n}\n";
+    std::remove(runsFile.c_str());
+    std::cout << "\n === TestEm3 benchmark: summary written into " << benchJSONFile << std::endl;
+  }
+  if (numFailed > 0) {
+    return 1;
+  }
+  // compare the A/B results for each number of threads
+  int numNotCompatible = 0;
+  if (isABComparison) {
+    const double alpha = 0.01;
+    for (const std::string& threads : benchThreads) {
+      BenchmarkResult resA, resB;
+      if (!ReadBenchmarkResult(obsFileName(benchPhysics[0], threads), resA)
+          || !ReadBenchmarkResult(obsFileName(benchPhysics[1], threads), resB)) {
+        return 1;
+      }
+      numNotCompatible += CompareBenchmarkResults(resA, resB, alpha, std::cout);
+    }
+  }
+  return numNotCompatible > 0 ? 2 : 0;
+}
+
+
+// =============================================================================
+std::vector<std::string> SplitList(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+
+// =============================================================================
+double SteadyTime() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
 // =============================================================================
 void help() {
   std::cout<<"\n "<<std::setw(100)<<std::setfill('=')<<""<<std::setfill(' ')<<std::endl;
@@ -150,6 +353,12 @@ void help() {
            <<"      -p :   flag  ==> run the application in performance mode i.e. no scoring \n"
            <<"         :   -     ==> run the application in NON performance mode i.e. with scoring (default) \n"
            <<"      -m :   REQUIRED : the standard Geamt4 macro file\n"
+           <<"      -b :   benchmark mode ==> comma separated list of physics to run with (default: as in the macro)\n"
+           <<"      -t :   benchmark mode ==> comma separated list of number of threads (default: as in the macro)\n"
+           <<"      -j :   benchmark mode ==> JSON summary file of the runs (default: none)\n"
+           <<"      -a :   A/B comparison mode ==> the two physics to compare, e.g. HepEmTracking,G4EmTracking\n"
+           <<"             (throughput per region and particle, KS tests of the per-event observables)\n"
+           <<"      -o :   benchmark mode ==> prefix of the per-event observables files (default: none)\n"
            << std::endl;
 
   std::cout<<"\nUsage: TestEm3 [OPTIONS] INPUT_FILE\n\n"<<std::endl;
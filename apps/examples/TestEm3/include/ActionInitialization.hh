@@ -32,6 +32,7 @@
 #define ActionInitialization_h 1
 
 #include "G4VUserActionInitialization.hh"
+#include "globals.hh"
 
 class DetectorConstruction;
 class G4VSteppingVerbose;
@@ -52,9 +53,24 @@ class ActionInitialization : public G4VUserActionInitialization
 
     void SetPerformanceModeFlag(bool val) { fIsPerformance = val; }
 
+    // Benchmark mode (see `RunAction::SetBenchmarkMode`): no scoring, only the
+    // tracks and steps are counted by the `BenchmarkTrackingAction`.
+    void SetBenchmarkMode(const G4String& resultFile, G4double startTime) {
+      fIsBenchmark   = true;
+      fBenchmarkFile = resultFile;
+      fStartTime     = startTime;
+    }
+    // A/B comparison mode of the benchmark: the per-event observables are also
+    // collected and written into `obsFile` (see `RunAction::WriteObservables`).
+    void SetObservablesFile(const G4String& obsFile) { fObservablesFile = obsFile; }
+
   private:
     DetectorConstruction *fDetector;
     bool                  fIsPerformance;
+    bool                  fIsBenchmark;
+    G4String              fBenchmarkFile;
+    G4String              fObservablesFile;
+    G4double              fStartTime;
 
 };
 
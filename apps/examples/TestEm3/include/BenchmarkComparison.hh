@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm3/include/BenchmarkComparison.hh
+/// \brief Definition of the A/B comparison of the benchmark results
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef BenchmarkComparison_h
+#define BenchmarkComparison_h 1
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// The results of a benchmark run as read from its observables file (written by
+// `RunAction::WriteObservables`): the throughput per region and particle and
+// the values of the per-event observables.
+
+struct BenchmarkResult {
+  struct Throughput {
+    std::string fRegion;
+    std::string fParticle;
+    long        fNumTracks;
+    long        fNumSteps;
+    double      fTrackingTime;
+  };
+
+  std::string fPhysics;
+  int         fNumThreads = 0;
+  long        fNumEvents  = 0;
+  double      fLoopTime   = 0.;
+
+  std::vector<Throughput>          fThroughput;
+  // names of the observables and their values for all events (per observable)
+  std::vector<std::string>         fNames;
+  std::vector<std::vector<double>> fValues;
+};
+
+// Reads the benchmark results from the given observables file (returns false on failure).
+bool ReadBenchmarkResult(const std::string& fileName, BenchmarkResult& result);
+
+// Two-sample Kolmogorov-Smirnov test: returns the statistic and sets the
+// (asymptotic) p-value of the compatibility of the two samples.
+double KolmogorovSmirnovTest(std::vector<double> a, std::vector<double> b, double& pValue);
+
+// Prints the relative throughput (A over B) per region and particle and the
+// KS tests of all per-event observables. An observable is reported as not
+// compatible if its p-value is below `alpha`/(number of observables), i.e.
+// the Bonferroni correction of the multiple tests. Returns the number of not
+// compatible observables.
+int CompareBenchmarkResults(const BenchmarkResult& resA, const BenchmarkResult& resB,
+                            double alpha, std::ostream& os);
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
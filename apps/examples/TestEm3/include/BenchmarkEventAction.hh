@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm3/include/BenchmarkEventAction.hh
+/// \brief Definition of the BenchmarkEventAction class
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef BenchmarkEventAction_h
+#define BenchmarkEventAction_h 1
+
+#include "G4UserEventAction.hh"
+#include "globals.hh"
+
+#include "BenchmarkRun.hh"
+
+#include <vector>
+
+class DetectorConstruction;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Collects the per-event observables in the A/B comparison mode of the
+// benchmark (filled by the `BenchmarkSteppingAction` and `BenchmarkTrackingAction`)
+// and adds them to the `BenchmarkRun` at the end of the event. The observables
+// (see `GetObservableNames`) are:
+//  - the energy deposit in each absorber and in each layer,
+//  - the longitudinal and lateral energy leakage (energy leaving the world),
+//  - the number of tracks and steps of gamma, e- and e+.
+
+class BenchmarkEventAction : public G4UserEventAction
+{
+  public:
+    BenchmarkEventAction(DetectorConstruction*);
+   ~BenchmarkEventAction();
+
+    virtual void BeginOfEventAction(const G4Event*);
+    virtual void   EndOfEventAction(const G4Event*);
+
+    void AddEnergyDeposit(G4int absor, G4int layer, G4double edep) {
+      fObservables[absor-1]         += edep;
+      fObservables[fIndxLayer+layer] += edep;
+    }
+    void AddLeakage(G4bool isLateral, G4double eleak) {
+      fObservables[fIndxLeak + (isLateral ? 1 : 0)] += eleak;
+    }
+    // `ptype` is one of the `BenchmarkRun` particle types
+    void AddTrack(G4int ptype, G4int numSteps) {
+      if (ptype < BenchmarkRun::kOther) {
+        fObservables[fIndxTracks+ptype] += 1.;
+        fObservables[fIndxSteps+ptype]  += numSteps;
+      }
+    }
+
+    // names of the observables (in the order of their per-event values)
+    static std::vector<G4String> GetObservableNames(DetectorConstruction*);
+
+  private:
+    DetectorConstruction* fDetector;
+
+    std::vector<G4double> fObservables;
+    G4int                 fIndxLeak;
+    G4int                 fIndxTracks;
+    G4int                 fIndxSteps;
+    G4int                 fIndxLayer;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,76 @@
+//
+/// \file electromagnetic/TestEm3/include/BenchmarkRun.hh
+/// \brief Definition of the BenchmarkRun class
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef BenchmarkRun_h
+#define BenchmarkRun_h 1
+
+#include "G4Run.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4ParticleDefinition;
+class G4Region;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// The run used in the benchmark mode: only the number of tracks, their steps
+// and tracking times per region (where the track was created) and particle type
+// are collected (by the `BenchmarkTrackingAction`) and merged. In the A/B
+// comparison mode, the per-event observables (see `BenchmarkEventAction`) are
+// also collected.
+
+class BenchmarkRun : public G4Run
+{
+  public:
+    enum { kGamma = 0, kElectron, kPositron, kOther, kNumParticleTypes };
+
+    BenchmarkRun();
+   ~BenchmarkRun();
+
+    virtual void Merge(const G4Run*);
+
+    void AddTrack(G4int region, G4int ptype, G4int numSteps, G4double time);
+
+    void AddEventObservables(const std::vector<G4double>& obs) {
+      fEventObservables.insert(fEventObservables.end(), obs.begin(), obs.end());
+    }
+
+    G4long GetNumTracks(G4int ptype) const { return fNumTracks[ptype]; }
+    G4long GetNumSteps(G4int ptype)  const { return fNumSteps[ptype];  }
+
+    G4int    GetNumRegions() const { return fNumRegions; }
+    G4long   GetNumTracks(G4int region, G4int ptype) const { return fRegionNumTracks[region*kNumParticleTypes+ptype]; }
+    G4long   GetNumSteps(G4int region, G4int ptype)  const { return fRegionNumSteps[region*kNumParticleTypes+ptype];  }
+    // sum of the tracking times [s] (i.e. over all threads)
+    G4double GetTrackingTime(G4int region, G4int ptype) const { return fRegionTime[region*kNumParticleTypes+ptype]; }
+
+    // the observables of all events (one after the other)
+    const std::vector<G4double>& GetEventObservables() const { return fEventObservables; }
+
+    static G4int GetParticleType(const G4ParticleDefinition* particle);
+    static const char* GetParticleTypeName(G4int ptype);
+
+    // index of the region in the region store
+    static G4int GetRegionIndex(const G4Region* region);
+    static const G4String& GetRegionName(G4int region);
+
+  private:
+    G4long fNumTracks[kNumParticleTypes];
+    G4long fNumSteps[kNumParticleTypes];
+
+    G4int                 fNumRegions;
+    std::vector<G4long>   fRegionNumTracks;
+    std::vector<G4long>   fRegionNumSteps;
+    std::vector<G4double> fRegionTime;
+
+    std::vector<G4double> fEventObservables;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
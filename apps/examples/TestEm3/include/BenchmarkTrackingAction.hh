@@ -0,0 +1,43 @@
+//
+/// \file electromagnetic/TestEm3/include/BenchmarkTrackingAction.hh
+/// \brief Definition of the BenchmarkTrackingAction class
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef BenchmarkTrackingAction_h
+#define BenchmarkTrackingAction_h 1
+
+#include "G4UserTrackingAction.hh"
+#include "globals.hh"
+
+#include <chrono>
+
+class BenchmarkEventAction;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// The only user action of the benchmark mode: counts the tracks and their steps
+// (at the end of the tracks, i.e. no stepping action is needed) and measures
+// their tracking times per region (where the track was created) and particle.
+// The tracks are also added to the per-event observables in the A/B comparison
+// mode (i.e. when the `BenchmarkEventAction` is given).
+
+class BenchmarkTrackingAction : public G4UserTrackingAction {
+
+  public:
+    BenchmarkTrackingAction(BenchmarkEventAction* evt = nullptr)
+    : G4UserTrackingAction(), fEventAct(evt) {}
+   ~BenchmarkTrackingAction() {}
+
+    virtual void PreUserTrackingAction(const G4Track*);
+    virtual void PostUserTrackingAction(const G4Track*);
+
+  private:
+    BenchmarkEventAction*                 fEventAct;
+    std::chrono::steady_clock::time_point fTrackStartTime;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -55,6 +55,12 @@ public:
 
     void AddPhysicsList(const G4String& name);
 
+    // Sets the given EM physics and ignores any later `AddPhysicsList` (e.g.
+    // from the macro) requests (used in the benchmark mode).
+    void ForcePhysicsList(const G4String& name);
+
+    const G4String& GetEmName() const { return fEmName; }
+
 private:
 
     PhysicsListMessenger* fMessenger;
@@ -62,6 +68,8 @@ private:
     G4String fEmName;
     G4VPhysicsConstructor*  fEmPhysicsList;
     G4VPhysicsConstructor*  fEmExtraPhysics;
+
+    G4bool   fIsForced;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -45,6 +45,7 @@ class PrimaryGeneratorAction;
 class RunActionMessenger;
 class HistoManager;
 class G4Timer;
+class BenchmarkRun;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -65,6 +66,22 @@ public:
 
   void SetPerformanceFlag(G4bool val)  { fIsPerformance = val; }
 
+  // Benchmark mode: only the tracks and steps are counted and the (master)
+  // reports the throughput and the initialisation/event loop times. The results
+  // are also appended to `resultFile` (if any) as JSON objects. `startTime` is
+  // the (steady clock) time of the program start in [s].
+  void SetBenchmarkMode(const G4String& resultFile, G4double startTime);
+  // The per-event observables of the benchmark mode (if collected, i.e. in the
+  // A/B comparison mode) are written into this file (see `WriteObservables`).
+  void SetObservablesFile(const G4String& obsFile) { fObservablesFile = obsFile; }
+
+private:
+  // Prints the results of the benchmark mode and appends them to the file.
+  void ReportBenchmark(const BenchmarkRun* run, G4double loopTime);
+  // Writes the throughput per region and particle and the per-event observables
+  // into the observables file (text format, read by the A/B comparison).
+  void WriteObservables(const BenchmarkRun* run, G4double loopTime);
+
 private:
   G4bool                  fIsPerformance;
   DetectorConstruction*   fDetector;
@@ -73,6 +90,13 @@ private:
   RunActionMessenger*     fRunMessenger;
   HistoManager*           fHistoManager;
   G4Timer*                fTimer;
+  // benchmark mode
+  G4bool                  fIsBenchmark;
+  G4String                fBenchmarkFile;
+  G4String                fObservablesFile;
+  G4double                fStartTime;
+  G4double                fInitTime;
+  G4double                fBeginOfRunTime;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -36,11 +36,15 @@
 #include "TrackingAction.hh"
 #include "SteppingAction.hh"
 #include "SteppingVerbose.hh"
+#include "BenchmarkTrackingAction.hh"
+#include "BenchmarkEventAction.hh"
+#include "BenchmarkSteppingAction.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 ActionInitialization::ActionInitialization(DetectorConstruction* det, bool isperformance)
- : G4VUserActionInitialization(),fDetector(det),fIsPerformance(isperformance)
+ : G4VUserActionInitialization(),fDetector(det),fIsPerformance(isperformance),
+   fIsBenchmark(false),fBenchmarkFile(""),fObservablesFile(""),fStartTime(0.)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -54,6 +58,10 @@ void ActionInitialization::BuildForMaster() const
 {
   RunAction* masterRunAct = new RunAction(fDetector);
   masterRunAct->SetPerformanceFlag(fIsPerformance);
+  if (fIsBenchmark) {
+    masterRunAct->SetBenchmarkMode(fBenchmarkFile, fStartTime);
+    masterRunAct->SetObservablesFile(fObservablesFile);
+  }
   SetUserAction(masterRunAct);
 }
 
@@ -65,7 +73,20 @@ void ActionInitialization::Build() const
   PrimaryGeneratorAction* prim = new PrimaryGeneratorAction(fDetector);
   fDetector->SetPrimaryGenerator(prim);
   SetUserAction(prim);
-  if (!fIsPerformance) {
+  if (fIsBenchmark) {
+    RunAction* run = new RunAction(fDetector,prim);
+    run->SetBenchmarkMode(fBenchmarkFile, fStartTime);
+    run->SetObservablesFile(fObservablesFile);
+    SetUserAction(run);
+    if (fObservablesFile.empty()) {
+      SetUserAction(new BenchmarkTrackingAction);
+    } else {
+      BenchmarkEventAction* event = new BenchmarkEventAction(fDetector);
+      SetUserAction(event);
+      SetUserAction(new BenchmarkTrackingAction(event));
+      SetUserAction(new BenchmarkSteppingAction(fDetector, event));
+    }
+  } else if (!fIsPerformance) {
     RunAction* run = new RunAction(fDetector,prim);
     SetUserAction(run);
     EventAction* event = new EventAction(fDetector);
@@ -0,0 +1,194 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm3/src/BenchmarkComparison.cc
+/// \brief Implementation of the A/B comparison of the benchmark results
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "BenchmarkComparison.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <iostream>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ReadBenchmarkResult(const std::string& fileName, BenchmarkResult& result)
+{
+  std::ifstream in(fileName);
+  if (!in) {
+    std::cerr << " *** ERROR in ReadBenchmarkResult: cannot open file = " << fileName << std::endl;
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream ss(line);
+    if (line[0] == '#') {
+      std::string hash, key;
+      ss >> hash >> key;
+      if (key == "physics") {
+        ss >> result.fPhysics;
+      } else if (key == "threads") {
+        ss >> result.fNumThreads;
+      } else if (key == "events") {
+        ss >> result.fNumEvents;
+      } else if (key == "event_loop_time_s") {
+        ss >> result.fLoopTime;
+      } else if (key == "throughput") {
+        BenchmarkResult::Throughput thr;
+        ss >> thr.fRegion >> thr.fParticle >> thr.fNumTracks >> thr.fNumSteps >> thr.fTrackingTime;
+        result.fThroughput.push_back(thr);
+      } else if (key == "columns") {
+        std::string name;
+        while (ss >> name) {
+          result.fNames.push_back(name);
+        }
+        result.fValues.resize(result.fNames.size());
+      }
+      continue;
+    }
+    double val;
+    for (std::size_t i=0; i<result.fValues.size() && ss >> val; ++i) {
+      result.fValues[i].push_back(val);
+    }
+  }
+  if (result.fNames.empty()) {
+    std::cerr << " *** ERROR in ReadBenchmarkResult: no observables in file = " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+double KolmogorovSmirnovTest(std::vector<double> a, std::vector<double> b, double& pValue)
+{
+  pValue = 1.0;
+  if (a.empty() || b.empty()) {
+    return 0.0;
+  }
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+  const double na = a.size();
+  const double nb = b.size();
+  // maximum distance of the two empirical cumulative distributions
+  double dist = 0.0;
+  std::size_t ia = 0, ib = 0;
+  while (ia < a.size() && ib < b.size()) {
+    const double x = std::min(a[ia], b[ib]);
+    while (ia < a.size() && a[ia] <= x) ++ia;
+    while (ib < b.size() && b[ib] <= x) ++ib;
+    dist = std::max(dist, std::abs(ia/na - ib/nb));
+  }
+  // asymptotic distribution of the statistic (with the small sample correction)
+  const double ne     = std::sqrt(na*nb/(na + nb));
+  const double lambda = (ne + 0.12 + 0.11/ne)*dist;
+  if (lambda < 0.2) {
+    return dist;
+  }
+  double sum  = 0.0;
+  double sign = 1.0;
+  for (int j=1; j<=100; ++j) {
+    const double term = sign*std::exp(-2.0*j*j*lambda*lambda);
+    sum  += term;
+    sign  = -sign;
+    if (std::abs(term) < 1.0E-10*sum) {
+      break;
+    }
+  }
+  pValue = std::min(1.0, std::max(0.0, 2.0*sum));
+  return dist;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int CompareBenchmarkResults(const BenchmarkResult& resA, const BenchmarkResult& resB,
+                            double alpha, std::ostream& os)
+{
+  os << "\n ===  A/B comparison: A = " << resA.fPhysics << " vs. B = " << resB.fPhysics
+     << " (threads = " << resA.fNumThreads << ", events = " << resA.fNumEvents
+     << " vs. " << resB.fNumEvents << ")" << std::endl;
+  // throughput: steps per tracking time per region and particle
+  os << "\n   Relative throughput (steps/s of A over B, per region of the track creation and particle):\n"
+     << std::setw(24) << "region" << std::setw(10) << "particle" << std::setw(16) << "steps/s (A)"
+     << std::setw(16) << "steps/s (B)" << std::setw(12) << "A/B" << std::endl;
+  for (const BenchmarkResult::Throughput& thrA : resA.fThroughput) {
+    for (const BenchmarkResult::Throughput& thrB : resB.fThroughput) {
+      if (thrA.fRegion != thrB.fRegion || thrA.fParticle != thrB.fParticle
+          || thrA.fTrackingTime <= 0. || thrB.fTrackingTime <= 0.) {
+        continue;
+      }
+      const double rateA = thrA.fNumSteps/thrA.fTrackingTime;
+      const double rateB = thrB.fNumSteps/thrB.fTrackingTime;
+      os << std::setw(24) << thrA.fRegion << std::setw(10) << thrA.fParticle
+         << std::setw(16) << rateA << std::setw(16) << rateB
+         << std::setw(12) << (rateB > 0. ? rateA/rateB : 0.) << std::endl;
+    }
+  }
+  if (resA.fLoopTime > 0. && resB.fLoopTime > 0.) {
+    const double evRateA = resA.fNumEvents/resA.fLoopTime;
+    const double evRateB = resB.fNumEvents/resB.fLoopTime;
+    os << std::setw(34) << "events/s" << std::setw(16) << evRateA << std::setw(16) << evRateB
+       << std::setw(12) << evRateA/evRateB << std::endl;
+  }
+  // KS tests of the per-event observables
+  const double pCut = alpha/std::max<std::size_t>(1, resA.fNames.size());
+  os << "\n   Kolmogorov-Smirnov tests of the per-event observables (not compatible if p < "
+     << pCut << "):\n"
+     << std::setw(20) << "observable" << std::setw(16) << "mean (A)" << std::setw(16) << "mean (B)"
+     << std::setw(12) << "KS-dist." << std::setw(12) << "p-value" << std::endl;
+  int numFailed = 0;
+  for (std::size_t i=0; i<resA.fNames.size(); ++i) {
+    const auto it = std::find(resB.fNames.begin(), resB.fNames.end(), resA.fNames[i]);
+    if (it == resB.fNames.end()) {
+      continue;
+    }
+    const std::vector<double>& valA = resA.fValues[i];
+    const std::vector<double>& valB = resB.fValues[it - resB.fNames.begin()];
+    double pValue;
+    const double dist  = KolmogorovSmirnovTest(valA, valB, pValue);
+    const double meanA = valA.empty() ? 0. : std::accumulate(valA.begin(), valA.end(), 0.)/valA.size();
+    const double meanB = valB.empty() ? 0. : std::accumulate(valB.begin(), valB.end(), 0.)/valB.size();
+    const bool isFailed = pValue < pCut;
+    numFailed += isFailed ? 1 : 0;
+    os << std::setw(20) << resA.fNames[i] << std::setw(16) << meanA << std::setw(16) << meanB
+       << std::setw(12) << dist << std::setw(12) << pValue << (isFailed ? "   <== NOT COMPATIBLE" : "")
+       << std::endl;
+  }
+  os << "\n   " << numFailed << " of the " << resA.fNames.size()
+     << " observables are not compatible." << std::endl;
+  return numFailed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,96 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm3/src/BenchmarkEventAction.cc
+/// \brief Implementation of the BenchmarkEventAction class
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "BenchmarkEventAction.hh"
+
+#include "BenchmarkRun.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4RunManager.hh"
+#include "G4Event.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BenchmarkEventAction::BenchmarkEventAction(DetectorConstruction* det)
+: G4UserEventAction(), fDetector(det),
+  fIndxLeak(0), fIndxTracks(0), fIndxSteps(0), fIndxLayer(0)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BenchmarkEventAction::~BenchmarkEventAction()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BenchmarkEventAction::BeginOfEventAction(const G4Event*)
+{
+  // the geometry might be changed between the runs
+  const G4int numAbsor = fDetector->GetNbOfAbsor();
+  fIndxLeak   = numAbsor;
+  fIndxTracks = fIndxLeak + 2;
+  fIndxSteps  = fIndxTracks + BenchmarkRun::kOther;
+  fIndxLayer  = fIndxSteps + BenchmarkRun::kOther;
+  fObservables.assign(fIndxLayer + fDetector->GetNbOfLayers(), 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BenchmarkEventAction::EndOfEventAction(const G4Event*)
+{
+  BenchmarkRun* run = static_cast<BenchmarkRun*>(
+                      G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  run->AddEventObservables(fObservables);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4String> BenchmarkEventAction::GetObservableNames(DetectorConstruction* det)
+{
+  std::vector<G4String> names;
+  for (G4int k=1; k<=det->GetNbOfAbsor(); ++k) {
+    names.push_back("Edep_absor" + std::to_string(k));
+  }
+  names.push_back("Leak_longitudinal");
+  names.push_back("Leak_lateral");
+  for (G4int ip=0; ip<BenchmarkRun::kOther; ++ip) {
+    names.push_back(G4String("NTracks_") + BenchmarkRun::GetParticleTypeName(ip));
+  }
+  for (G4int ip=0; ip<BenchmarkRun::kOther; ++ip) {
+    names.push_back(G4String("NSteps_") + BenchmarkRun::GetParticleTypeName(ip));
+  }
+  for (G4int il=0; il<det->GetNbOfLayers(); ++il) {
+    names.push_back("Edep_layer" + std::to_string(il));
+  }
+  return names;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,108 @@
+//
+/// \file electromagnetic/TestEm3/src/BenchmarkRun.cc
+/// \brief Implementation of the BenchmarkRun class
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "BenchmarkRun.hh"
+
+#include "G4Gamma.hh"
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BenchmarkRun::BenchmarkRun()
+: G4Run()
+{
+  for (G4int i=0; i<kNumParticleTypes; ++i) {
+    fNumTracks[i] = 0;
+    fNumSteps[i]  = 0;
+  }
+  fNumRegions = G4RegionStore::GetInstance()->size();
+  fRegionNumTracks.resize(fNumRegions*kNumParticleTypes, 0);
+  fRegionNumSteps.resize(fNumRegions*kNumParticleTypes, 0);
+  fRegionTime.resize(fNumRegions*kNumParticleTypes, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BenchmarkRun::~BenchmarkRun()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BenchmarkRun::AddTrack(G4int region, G4int ptype, G4int numSteps, G4double time)
+{
+  fNumTracks[ptype] += 1;
+  fNumSteps[ptype]  += numSteps;
+  const G4int indx = region*kNumParticleTypes + ptype;
+  fRegionNumTracks[indx] += 1;
+  fRegionNumSteps[indx]  += numSteps;
+  fRegionTime[indx]      += time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BenchmarkRun::Merge(const G4Run* run)
+{
+  const BenchmarkRun* localRun = static_cast<const BenchmarkRun*>(run);
+  for (G4int i=0; i<kNumParticleTypes; ++i) {
+    fNumTracks[i] += localRun->fNumTracks[i];
+    fNumSteps[i]  += localRun->fNumSteps[i];
+  }
+  for (std::size_t i=0; i<fRegionTime.size(); ++i) {
+    fRegionNumTracks[i] += localRun->fRegionNumTracks[i];
+    fRegionNumSteps[i]  += localRun->fRegionNumSteps[i];
+    fRegionTime[i]      += localRun->fRegionTime[i];
+  }
+  fEventObservables.insert(fEventObservables.end(), localRun->fEventObservables.begin(),
+                           localRun->fEventObservables.end());
+  G4Run::Merge(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int BenchmarkRun::GetParticleType(const G4ParticleDefinition* particle)
+{
+  if (particle == G4Gamma::Definition()) {
+    return kGamma;
+  } else if (particle == G4Electron::Definition()) {
+    return kElectron;
+  } else if (particle == G4Positron::Definition()) {
+    return kPositron;
+  }
+  return kOther;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* BenchmarkRun::GetParticleTypeName(G4int ptype)
+{
+  static const char* names[kNumParticleTypes] = {"gamma", "e-", "e+", "other"};
+  return names[ptype];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int BenchmarkRun::GetRegionIndex(const G4Region* region)
+{
+  const G4RegionStore* store = G4RegionStore::GetInstance();
+  const auto it = std::find(store->begin(), store->end(), region);
+  // tracks with unknown region are assigned to the first (world) region
+  return it != store->end() ? G4int(it - store->begin()) : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& BenchmarkRun::GetRegionName(G4int region)
+{
+  return (*G4RegionStore::GetInstance())[region]->GetName();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file electromagnetic/TestEm3/src/BenchmarkSteppingAction.cc
+/// \brief Implementation of the BenchmarkSteppingAction class
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "BenchmarkSteppingAction.hh"
+
+#include "BenchmarkEventAction.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4Step.hh"
+#include "G4Positron.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BenchmarkSteppingAction::BenchmarkSteppingAction(DetectorConstruction* det,
+                                                 BenchmarkEventAction* evt)
+: G4UserSteppingAction(), fDetector(det), fEventAct(evt)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BenchmarkSteppingAction::~BenchmarkSteppingAction()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BenchmarkSteppingAction::UserSteppingAction(const G4Step* aStep)
+{
+  const G4StepPoint* prePoint = aStep->GetPreStepPoint();
+  const G4StepPoint* endPoint = aStep->GetPostStepPoint();
+
+  // leakage: energy leaving the world (lateral if through one of the side faces)
+  if (endPoint->GetStepStatus() == fWorldBoundary) {
+    G4double eleak = endPoint->GetKineticEnergy();
+    if (aStep->GetTrack()->GetDefinition() == G4Positron::Positron()) {
+      eleak += 2*electron_mass_c2;
+    }
+    const G4ThreeVector& pos = endPoint->GetPosition();
+    const G4double relX  = std::abs(pos.x())/fDetector->GetWorldSizeX();
+    const G4double relYZ = std::max(std::abs(pos.y()), std::abs(pos.z()))/fDetector->GetWorldSizeYZ();
+    fEventAct->AddLeakage(relYZ > relX, eleak);
+  }
+
+  // energy deposit in the absorbers (as in the `SteppingAction`)
+  const G4double edep = aStep->GetTotalEnergyDeposit()*aStep->GetTrack()->GetWeight();
+  if (edep <= 0.) {
+    return;
+  }
+  const G4VTouchable* touchable = prePoint->GetTouchableHandle()();
+  if (touchable->GetVolume()->GetLogicalVolume()->GetMaterial() == fDetector->GetWorldMaterial()) {
+    return;
+  }
+  fEventAct->AddEnergyDeposit(touchable->GetCopyNumber(0), touchable->GetCopyNumber(1), edep);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,42 @@
+//
+/// \file electromagnetic/TestEm3/src/BenchmarkTrackingAction.cc
+/// \brief Implementation of the BenchmarkTrackingAction class
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "BenchmarkTrackingAction.hh"
+
+#include "BenchmarkRun.hh"
+#include "BenchmarkEventAction.hh"
+
+#include "G4RunManager.hh"
+#include "G4Track.hh"
+#include "G4LogicalVolume.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BenchmarkTrackingAction::PreUserTrackingAction(const G4Track*)
+{
+  fTrackStartTime = std::chrono::steady_clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BenchmarkTrackingAction::PostUserTrackingAction(const G4Track* track)
+{
+  const G4double time = std::chrono::duration<G4double>(
+                        std::chrono::steady_clock::now() - fTrackStartTime).count();
+  const G4LogicalVolume* lvol = track->GetLogicalVolumeAtVertex();
+  const G4int region   = lvol != nullptr ? BenchmarkRun::GetRegionIndex(lvol->GetRegion()) : 0;
+  const G4int ptype    = BenchmarkRun::GetParticleType(track->GetDefinition());
+  const G4int numSteps = track->GetCurrentStepNumber();
+  BenchmarkRun* run = static_cast<BenchmarkRun*>(
+                      G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  run->AddTrack(region, ptype, numSteps, time);
+  if (fEventAct != nullptr) {
+    fEventAct->AddTrack(ptype, numSteps);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -78,7 +78,7 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PhysicsList::PhysicsList() : G4VModularPhysicsList(),
- fEmPhysicsList(0), fMessenger(0)
+ fEmPhysicsList(0), fMessenger(0), fIsForced(false)
 {
   G4LossTableManager::Instance();
   SetDefaultCutValue(1*mm);
@@ -177,6 +177,13 @@ void PhysicsList::AddPhysicsList(const G4String& name)
 
   if (name == fEmName) return;
 
+  if (fIsForced) {
+    G4cout << "PhysicsList::AddPhysicsList: <" << name << ">"
+           << " is ignored (<" << fEmName << "> is forced)"
+           << G4endl;
+    return;
+  }
+
   if (name == "local") {
 
     fEmName = name;
@@ -232,3 +239,13 @@ void PhysicsList::AddPhysicsList(const G4String& name)
   fEmPhysicsList->SetVerboseLevel(verboseLevel);
   G4EmParameters::Instance()->SetVerbose(verboseLevel);
 }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::ForcePhysicsList(const G4String& name)
+{
+  AddPhysicsList(name);
+  fIsForced = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -38,16 +38,31 @@
 #include "RunActionMessenger.hh"
 #include "HistoManager.hh"
 #include "Run.hh"
+#include "BenchmarkRun.hh"
+#include "BenchmarkEventAction.hh"
+#include "PhysicsList.hh"
 #include "G4Timer.hh"
 #include "G4RunManager.hh"
 #include "Randomize.hh"
 
 #include "G4ProductionCutsTable.hh"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+  // current time of the steady clock in [s]
+  G4double SteadyTime() {
+    return std::chrono::duration<G4double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+}
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::RunAction(DetectorConstruction* det, PrimaryGeneratorAction* prim)
 :G4UserRunAction(), fIsPerformance(false), fDetector(det), fPrimary(prim), fRun(0), fRunMessenger(0),
- fHistoManager(0), fTimer(0)
+ fHistoManager(0), fTimer(0), fIsBenchmark(false), fBenchmarkFile(""), fObservablesFile(""), fStartTime(0.),
+ fInitTime(-1.), fBeginOfRunTime(0.)
 {
   fRunMessenger = new RunActionMessenger(this);
   fHistoManager = new HistoManager();
@@ -62,8 +77,21 @@ RunAction::~RunAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void RunAction::SetBenchmarkMode(const G4String& resultFile, G4double startTime)
+{
+  fIsBenchmark   = true;
+  fIsPerformance = true;
+  fBenchmarkFile = resultFile;
+  fStartTime     = startTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 G4Run* RunAction::GenerateRun()
 {
+  if (fIsBenchmark) {
+    return new BenchmarkRun();
+  }
   if (!fIsPerformance) {
     fRun = new Run(fDetector);
     return fRun;
@@ -81,6 +109,11 @@ void RunAction::BeginOfRunAction(const G4Run*)
 
     fTimer = new G4Timer();
     fTimer->Start();
+    // the initialisation is measured till the beginning of the first run
+    fBeginOfRunTime = SteadyTime();
+    if (fInitTime < 0.) {
+      fInitTime = fBeginOfRunTime - fStartTime;
+    }
   }
 
   if (fIsPerformance) {
@@ -106,7 +139,7 @@ void RunAction::BeginOfRunAction(const G4Run*)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::EndOfRunAction(const G4Run*)
+void RunAction::EndOfRunAction(const G4Run* run)
 {
   // compute and print statistic
   if (isMaster) {
@@ -115,12 +148,20 @@ void RunAction::EndOfRunAction(const G4Run*)
     G4cout << "   Time:  "  << *fTimer << G4endl;
     G4cout << "  ======================================================" << G4endl;
     delete fTimer;
+    if (fIsBenchmark) {
+      ReportBenchmark(static_cast<const BenchmarkRun*>(run), SteadyTime() - fBeginOfRunTime);
+      return;
+    }
     if (!fIsPerformance) {
       fRun->EndOfRun();
     } else {
       return;
     }
   }
+  // nothing else to do in the benchmark mode (workers)
+  if (fIsBenchmark) {
+    return;
+  }
   //save histograms
   G4AnalysisManager* analysis = G4AnalysisManager::Instance();
   if (analysis->IsActive()) {
@@ -147,3 +188,127 @@ void RunAction::SetApplyLimit(G4bool val)
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::ReportBenchmark(const BenchmarkRun* run, G4double loopTime)
+{
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  const PhysicsList* physList = static_cast<const PhysicsList*>(runManager->GetUserPhysicsList());
+  const G4String& physName = physList->GetEmName();
+  const G4int numThreads   = runManager->GetNumberOfThreads();
+  const G4int numEvents    = run->GetNumberOfEvent();
+  const G4double norm      = loopTime > 0. ? 1./loopTime : 0.;
+  G4long numTracks = 0;
+  G4long numSteps  = 0;
+  for (G4int ip=0; ip<BenchmarkRun::kNumParticleTypes; ++ip) {
+    numTracks += run->GetNumTracks(ip);
+    numSteps  += run->GetNumSteps(ip);
+  }
+  G4cout << "  ======================================================" << G4endl;
+  G4cout << "   Benchmark: physics = " << physName << ", threads = " << numThreads
+         << ", events = " << numEvents << G4endl;
+  G4cout << "   Initialisation time [s] = " << fInitTime
+         << ", event loop time [s] = " << loopTime << G4endl;
+  G4cout << "   events/s = " << numEvents*norm << G4endl;
+  G4cout << std::setw(10) << "particle" << std::setw(16) << "tracks/s" << std::setw(16) << "steps/s" << G4endl;
+  for (G4int ip=0; ip<BenchmarkRun::kNumParticleTypes; ++ip) {
+    G4cout << std::setw(10) << BenchmarkRun::GetParticleTypeName(ip)
+           << std::setw(16) << run->GetNumTracks(ip)*norm
+           << std::setw(16) << run->GetNumSteps(ip)*norm << G4endl;
+  }
+  G4cout << std::setw(10) << "all" << std::setw(16) << numTracks*norm
+         << std::setw(16) << numSteps*norm << G4endl;
+  // tracking time (summed over the threads) per region (where the tracks were
+  // created) and particle
+  G4cout << "   Per region (of the track creation):" << G4endl;
+  G4cout << std::setw(24) << "region" << std::setw(10) << "particle" << std::setw(14) << "tracks"
+         << std::setw(14) << "steps" << std::setw(16) << "track.-time [s]" << std::setw(16) << "steps/s" << G4endl;
+  for (G4int ir=0; ir<run->GetNumRegions(); ++ir) {
+    for (G4int ip=0; ip<BenchmarkRun::kNumParticleTypes; ++ip) {
+      if (run->GetNumTracks(ir, ip) == 0) {
+        continue;
+      }
+      const G4double time = run->GetTrackingTime(ir, ip);
+      G4cout << std::setw(24) << BenchmarkRun::GetRegionName(ir)
+             << std::setw(10) << BenchmarkRun::GetParticleTypeName(ip)
+             << std::setw(14) << run->GetNumTracks(ir, ip)
+             << std::setw(14) << run->GetNumSteps(ir, ip)
+             << std::setw(16) << time
+             << std::setw(16) << (time > 0. ? run->GetNumSteps(ir, ip)/time : 0.) << G4endl;
+    }
+  }
+  G4cout << "  ======================================================" << G4endl;
+
+  if (!fObservablesFile.empty()) {
+    WriteObservables(run, loopTime);
+  }
+  if (fBenchmarkFile.empty()) {
+    return;
+  }
+  std::ofstream out(fBenchmarkFile, std::ios::app);
+  out << "    {\"physics\": \"" << physName << "\", \"threads\": " << numThreads
+      << ", \"events\": " << numEvents << ", \"init_time_s\": " << fInitTime
+      << ", \"event_loop_time_s\": " << loopTime << ", \"events_per_s\": " << numEvents*norm
+      << ", \"tracks_per_s\": " << numTracks*norm << ", \"steps_per_s\": " << numSteps*norm
+      << ", \"particles\": {";
+  for (G4int ip=0; ip<BenchmarkRun::kNumParticleTypes; ++ip) {
+    out << (ip > 0 ? ", " : "") << "\"" << BenchmarkRun::GetParticleTypeName(ip) << "\": {"
+        << "\"tracks\": " << run->GetNumTracks(ip) << ", \"steps\": " << run->GetNumSteps(ip)
+        << ", \"tracks_per_s\": " << run->GetNumTracks(ip)*norm
+        << ", \"steps_per_s\": " << run->GetNumSteps(ip)*norm << "}";
+  }
+  out << "}, \"regions\": {";
+  for (G4int ir=0; ir<run->GetNumRegions(); ++ir) {
+    out << (ir > 0 ? ", " : "") << "\"" << BenchmarkRun::GetRegionName(ir) << "\": {";
+    for (G4int ip=0; ip<BenchmarkRun::kNumParticleTypes; ++ip) {
+      out << (ip > 0 ? ", " : "") << "\"" << BenchmarkRun::GetParticleTypeName(ip) << "\": {"
+          << "\"tracks\": " << run->GetNumTracks(ir, ip) << ", \"steps\": " << run->GetNumSteps(ir, ip)
+          << ", \"tracking_time_s\": " << run->GetTrackingTime(ir, ip) << "}";
+    }
+    out << "}";
+  }
+  out << "}},\n";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::WriteObservables(const BenchmarkRun* run, G4double loopTime)
+{
+  std::ofstream out(fObservablesFile);
+  if (!out) {
+    G4cerr << " *** ERROR in RunAction::WriteObservables: cannot open file = "
+           << fObservablesFile << G4endl;
+    return;
+  }
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  const PhysicsList* physList = static_cast<const PhysicsList*>(runManager->GetUserPhysicsList());
+  out << std::setprecision(10);
+  out << "# TestEm3 benchmark observables\n";
+  out << "# physics " << physList->GetEmName() << "\n";
+  out << "# threads " << runManager->GetNumberOfThreads() << "\n";
+  out << "# events " << run->GetNumberOfEvent() << "\n";
+  out << "# event_loop_time_s " << loopTime << "\n";
+  for (G4int ir=0; ir<run->GetNumRegions(); ++ir) {
+    for (G4int ip=0; ip<BenchmarkRun::kNumParticleTypes; ++ip) {
+      out << "# throughput " << BenchmarkRun::GetRegionName(ir) << " "
+          << BenchmarkRun::GetParticleTypeName(ip) << " " << run->GetNumTracks(ir, ip) << " "
+          << run->GetNumSteps(ir, ip) << " " << run->GetTrackingTime(ir, ip) << "\n";
+    }
+  }
+  // the per-event observables (energies in internal units, i.e. [MeV])
+  const std::vector<G4String> names = BenchmarkEventAction::GetObservableNames(fDetector);
+  out << "# columns";
+  for (const G4String& name : names) {
+    out << " " << name;
+  }
+  out << "\n";
+  const std::vector<G4double>& obs = run->GetEventObservables();
+  const std::size_t numObs = names.size();
+  for (std::size_t i=0; i+numObs<=obs.size(); i+=numObs) {
+    for (std::size_t j=0; j<numObs; ++j) {
+      out << (j > 0 ? " " : "") << obs[i+j];
+    }
+    out << "\n";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,114 @@
+
+#include "BenchUtils.hh"
+
+#include "G4HepEmData.hh"
+#include "G4HepEmParameters.hh"
+#include "G4HepEmState.hh"
+#include "G4HepEmDataJsonIO.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef G4HepEmBench_CLHEP_ENGINE
+#include "CLHEP/Random/MixMaxRng.h"
+#else
+#include <random>
+#endif
+
+
+G4HepEmState* LoadState(const std::string& fileName) {
+  std::ifstream inf(fileName);
+  if (!inf) {
+    std::cerr << " *** ERROR in LoadState: cannot open the state file = "
+              << fileName << std::endl;
+    exit(1);
+  }
+  G4HepEmState* state = G4HepEmStateFromJson(inf);
+  if (state == nullptr || state->fData == nullptr || state->fParameters == nullptr) {
+    std::cerr << " *** ERROR in LoadState: cannot read the G4HepEmState from file = "
+              << fileName << std::endl;
+    exit(1);
+  }
+  return state;
+}
+
+
+void FreeState(G4HepEmState* state) {
+  if (state == nullptr) {
+    return;
+  }
+  FreeG4HepEmData(state->fData);
+  delete state->fData;
+  FreeG4HepEmParameters(state->fParameters);
+  delete state->fParameters;
+  delete state;
+}
+
+
+#ifdef G4HepEmBench_CLHEP_ENGINE
+
+BenchRandom::BenchRandom(unsigned long seed)
+: fEngine(new CLHEP::MixMaxRng(seed)), fHepEmEngine(fEngine) { }
+
+BenchRandom::~BenchRandom() {
+  delete static_cast<CLHEP::MixMaxRng*>(fEngine);
+}
+
+#else
+
+BenchRandom::BenchRandom(unsigned long seed)
+: fEngine(new std::mt19937_64(seed)), fHepEmEngine(fEngine) { }
+
+BenchRandom::~BenchRandom() {
+  delete static_cast<std::mt19937_64*>(fEngine);
+}
+
+// Implementation of the G4HepEmRandomEngine members (G4HepEm without Geant4):
+// uniform random numbers on the (0,1) open interval with 53 bit resolution.
+double G4HepEmRandomEngine::flat() {
+  const std::uint64_t rnd = (*static_cast<std::mt19937_64*>(fObject))();
+  return ((rnd >> 11) + 0.5)*(1.0/9007199254740992.0);
+}
+
+void G4HepEmRandomEngine::flatArray(const int size, double* vect) {
+  for (int i=0; i<size; ++i) {
+    vect[i] = flat();
+  }
+}
+
+#endif
+
+
+bool PopOption(int& argc, char** argv, const std::string& name, std::string& value) {
+  const std::string prefix = "--" + name + "=";
+  for (int i=1; i<argc; ++i) {
+    if (std::strncmp(argv[i], prefix.c_str(), prefix.size()) == 0) {
+      value = argv[i] + prefix.size();
+      for (int j=i; j<argc-1; ++j) {
+        argv[j] = argv[j+1];
+      }
+      --argc;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+std::string EnergyLabel(double ekin) {
+  const char* units[] = {"eV", "keV", "MeV", "GeV", "TeV"};
+  // ekin is in [MeV]: start from [eV]
+  double val = ekin*1.0E+6;
+  int    iu  = 0;
+  while (val >= 1000.0 && iu < 4) {
+    val *= 1.0E-3;
+    ++iu;
+  }
+  std::ostringstream os;
+  os << val << units[iu];
+  return os.str();
+}
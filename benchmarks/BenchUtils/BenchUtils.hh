@@ -0,0 +1,48 @@
+
+#ifndef BENCHUTILS_HH
+#define BENCHUTILS_HH
+
+// Common utilities of the (Geant4 independent) G4HepEm benchmarks:
+//  - loading/freeing the `G4HepEmState` (data and parameters) from JSON
+//  - a self-contained random number engine wrapped into a `G4HepEmRandomEngine`
+//  - simple command line and labeling helpers
+
+#include "G4HepEmRandomEngine.hh"
+
+#include <string>
+
+struct G4HepEmState;
+
+// Reads the `G4HepEmState` from the given JSON file (written by `G4HepEmStateToJson`).
+// Stops the application if the file cannot be read.
+G4HepEmState* LoadState(const std::string& fileName);
+
+// Frees the state (including its data and parameters) loaded by `LoadState`.
+void FreeState(G4HepEmState* state);
+
+
+// The random number engine used in the benchmarks: `CLHEP::MixMaxRng` in case of
+// G4HepEm built with Geant4 (i.e. the default engine of Geant4) while a 64 bit
+// Mersenne Twister otherwise (that also provides the implementation of the
+// `G4HepEmRandomEngine::flat` and `flatArray` members in this case).
+class BenchRandom {
+public:
+  BenchRandom(unsigned long seed = 1234567);
+ ~BenchRandom();
+
+  G4HepEmRandomEngine* GetEngine() { return &fHepEmEngine; }
+
+private:
+  void*               fEngine;
+  G4HepEmRandomEngine fHepEmEngine;
+};
+
+
+// Finds and removes the `--name=value` option from the command line arguments.
+// Returns true (and sets `value`) if the option was given.
+bool PopOption(int& argc, char** argv, const std::string& name, std::string& value);
+
+// Kinetic energy [MeV] label such as `10keV`, `1MeV` or `100GeV`.
+std::string EnergyLabel(double ekin);
+
+#endif // BENCHUTILS_HH
@@ -0,0 +1,446 @@
+
+// Scaling of the e-/e+ data lookup and step throughput with the number of
+// material-cuts couples, i.e. with the footprint of the per couple tables.
+//
+// The G4HepEm state (data and parameters) is loaded from a JSON file and its
+// couples are replicated (cyclically) to synthesize the data of geometries with
+// the required numbers of couples. All the per couple e-/e+ data, i.e. the
+// energy loss (`fELossData`), restricted macroscopic cross section
+// (`fResMacXSecData`) and target element selector data as well as the
+// Seltzer-Berger table indices, are replicated while the per material and per
+// element data (e.g. gamma, MSC and the Seltzer-Berger tables themselves) are
+// shared with the loaded state:
+//
+//   FootprintScaling --state=<state.json> [--couples=1,10,100,1000,5000,20000]
+//                    [--visits=65536] [--burst=16] [benchmark options]
+//
+// The couples and the e- kinetic energies (log-uniform between 1 keV and 10 GeV)
+// are visited in randomised order: `random` selects a new couple at each visit
+// while `burst` keeps the same couple for `--burst` consecutive visits (like the
+// steps of a track in a volume). The benchmarks are
+//
+//  - `Lookup/<pattern>/couples:<N>`: range, dE/dx, ionisation and bremsstrahlung
+//    restricted macroscopic cross section lookups of e- per visit,
+//  - `Step/<pattern>/couples:<N>`: e- `HowFar` followed by the `PerformDiscrete`
+//    of a randomly selected (ionisation or bremsstrahlung) interaction per visit,
+//
+// with `items_per_second` being the visits per second. The `table_MB` counter is
+// the size of the per couple e-/e+ tables and `LLC_misses` is the number of
+// last level cache (read) misses per visit, measured by `perf_event_open` where
+// available (Linux with sufficient `perf_event_paranoid` permission).
+
+#include "BenchUtils.hh"
+
+#include "G4HepEmData.hh"
+#include "G4HepEmParameters.hh"
+#include "G4HepEmState.hh"
+#include "G4HepEmMatCutData.hh"
+#include "G4HepEmElectronData.hh"
+#include "G4HepEmSBTableData.hh"
+
+#include "G4HepEmTLData.hh"
+#include "G4HepEmElectronManager.hh"
+#include "G4HepEmElectronTrack.hh"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+//
+// --- Synthesized data with the required number of couples
+//
+
+// Replicates the per couple blocks of `srcData` (given by their start indices
+// or -1 if there is no data for the couple) cyclically for `numDst` couples.
+// The blocks are stored continuously, i.e. each ends at the next start index.
+template <typename T>
+void ReplicateBlocks(const int* srcStart, const T* srcData, int srcNumData, int numSrc, int numDst,
+                     int*& dstStart, T*& dstData, int& dstNumData) {
+  std::vector<int> starts;
+  for (int i=0; i<numSrc; ++i) {
+    if (srcStart[i] >= 0) {
+      starts.push_back(srcStart[i]);
+    }
+  }
+  std::sort(starts.begin(), starts.end());
+  auto blockLength = [&](int start) {
+    const auto it = std::upper_bound(starts.begin(), starts.end(), start);
+    return (it == starts.end() ? srcNumData : *it) - start;
+  };
+  dstStart   = new int[numDst];
+  dstNumData = 0;
+  for (int i=0; i<numDst; ++i) {
+    const int start = srcStart[i % numSrc];
+    dstStart[i] = start < 0 ? -1 : dstNumData;
+    dstNumData += start < 0 ? 0 : blockLength(start);
+  }
+  dstData = new T[std::max(1, dstNumData)];
+  for (int i=0; i<numDst; ++i) {
+    const int start = srcStart[i % numSrc];
+    if (start >= 0) {
+      std::copy(srcData + start, srcData + start + blockLength(start), dstData + dstStart[i]);
+    }
+  }
+}
+
+G4HepEmElectronData* SynthesizeElectronData(const G4HepEmElectronData* src, int numDst) {
+  const int numSrc = src->fNumMatCuts;
+  // copy all members: the per material data arrays are shared with the source
+  G4HepEmElectronData* dst = new G4HepEmElectronData(*src);
+  dst->fNumMatCuts = numDst;
+  const int numELoss = 5*src->fELossEnergyGridSize;
+  dst->fELossData = new double[numELoss*numDst];
+  for (int i=0; i<numDst; ++i) {
+    std::copy(src->fELossData + (i % numSrc)*numELoss, src->fELossData + (i % numSrc + 1)*numELoss,
+              dst->fELossData + i*numELoss);
+  }
+  ReplicateBlocks(src->fResMacXSecStartIndexPerMatCut, src->fResMacXSecData, src->fResMacXSecNumData, numSrc,
+                  numDst, dst->fResMacXSecStartIndexPerMatCut, dst->fResMacXSecData, dst->fResMacXSecNumData);
+  ReplicateBlocks(src->fElemSelectorIoniStartIndexPerMatCut, src->fElemSelectorIoniData,
+                  src->fElemSelectorIoniNumData, numSrc, numDst, dst->fElemSelectorIoniStartIndexPerMatCut,
+                  dst->fElemSelectorIoniData, dst->fElemSelectorIoniNumData);
+  ReplicateBlocks(src->fElemSelectorBremSBStartIndexPerMatCut, src->fElemSelectorBremSBData,
+                  src->fElemSelectorBremSBNumData, numSrc, numDst, dst->fElemSelectorBremSBStartIndexPerMatCut,
+                  dst->fElemSelectorBremSBData, dst->fElemSelectorBremSBNumData);
+  ReplicateBlocks(src->fElemSelectorBremRBStartIndexPerMatCut, src->fElemSelectorBremRBData,
+                  src->fElemSelectorBremRBNumData, numSrc, numDst, dst->fElemSelectorBremRBStartIndexPerMatCut,
+                  dst->fElemSelectorBremRBData, dst->fElemSelectorBremRBNumData);
+  return dst;
+}
+
+void FreeSynthesizedElectronData(G4HepEmElectronData* data) {
+  // do not free the data shared with the source
+  data->fELossEnergyGrid = nullptr;
+  data->fENucEnergyGrid  = nullptr;
+  data->fENucMacXsecData = nullptr;
+  data->fTr1MacXSecData  = nullptr;
+  FreeElectronData(&data);
+}
+
+// Size of the per couple tables of e- or e+ in [MB].
+double PerCoupleTableMB(const G4HepEmElectronData* elData) {
+  const double numDoubles = 5.0*elData->fELossEnergyGridSize*elData->fNumMatCuts + elData->fResMacXSecNumData
+                            + elData->fElemSelectorIoniNumData + elData->fElemSelectorBremSBNumData
+                            + elData->fElemSelectorBremRBNumData;
+  const double numInts    = 4.0*elData->fNumMatCuts;
+  return (numDoubles*sizeof(double) + numInts*sizeof(int))/(1024.0*1024.0);
+}
+
+// The state with the synthesized data of the given number of couples.
+class SynthesizedState {
+public:
+  SynthesizedState(const G4HepEmState* src, int numCouples) {
+    const G4HepEmData* srcData = src->fData;
+    const int numSrc = srcData->fTheMatCutData->fNumMatCutData;
+    fData = new G4HepEmData(*srcData);
+    // couples
+    fData->fTheMatCutData = new G4HepEmMatCutData(*srcData->fTheMatCutData);
+    fData->fTheMatCutData->fNumMatCutData = numCouples;
+    fData->fTheMatCutData->fMatCutData    = new G4HepEmMCCData[numCouples];
+    for (int i=0; i<numCouples; ++i) {
+      fData->fTheMatCutData->fMatCutData[i] = srcData->fTheMatCutData->fMatCutData[i % numSrc];
+    }
+    // e-/e+ data
+    fData->fTheElectronData = SynthesizeElectronData(srcData->fTheElectronData, numCouples);
+    fData->fThePositronData = SynthesizeElectronData(srcData->fThePositronData, numCouples);
+    // Seltzer-Berger table indices (the tables per Z are shared)
+    const G4HepEmSBTableData* srcSB = srcData->fTheSBTableData;
+    fData->fTheSBTableData = new G4HepEmSBTableData(*srcSB);
+    fData->fTheSBTableData->fNumHepEmMatCuts = numCouples;
+    ReplicateBlocks(srcSB->fGammaCutIndxStartIndexPerMC, srcSB->fGammaCutIndices, srcSB->fNumElemsInMatCuts,
+                    numSrc, numCouples, fData->fTheSBTableData->fGammaCutIndxStartIndexPerMC,
+                    fData->fTheSBTableData->fGammaCutIndices, fData->fTheSBTableData->fNumElemsInMatCuts);
+    fState.fData       = fData;
+    fState.fParameters = src->fParameters;
+    // the e-/e+ tables, the Seltzer-Berger table indices and the couple data
+    const int numSBInts = numCouples + fData->fTheSBTableData->fNumElemsInMatCuts;
+    fTableMB = PerCoupleTableMB(fData->fTheElectronData) + PerCoupleTableMB(fData->fThePositronData)
+               + (numSBInts*sizeof(int) + numCouples*sizeof(G4HepEmMCCData))/(1024.0*1024.0);
+  }
+
+ ~SynthesizedState() {
+    fData->fTheMatCutData->fG4MCIndexToHepEmMCIndex = nullptr;
+    FreeMatCutData(&fData->fTheMatCutData);
+    FreeSynthesizedElectronData(fData->fTheElectronData);
+    FreeSynthesizedElectronData(fData->fThePositronData);
+    fData->fTheSBTableData->fSBTableData = nullptr;
+    FreeSBTableData(&fData->fTheSBTableData);
+    delete fData;
+  }
+
+  G4HepEmState* GetState() { return &fState; }
+  double        GetTableMB() const { return fTableMB; }
+
+private:
+  G4HepEmData* fData;
+  G4HepEmState fState;
+  double       fTableMB;
+};
+
+
+//
+// --- Last level cache miss counter
+//
+class LLCMissCounter {
+public:
+  LLCMissCounter() {
+#ifdef __linux__
+    perf_event_attr attr = {};
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HW_CACHE;
+    attr.config         = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    fFD = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fFD < 0) {
+      // the generic cache miss event (usually the last level cache)
+      attr.type   = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      fFD = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+  }
+ ~LLCMissCounter() {
+#ifdef __linux__
+    if (fFD >= 0) {
+      close(fFD);
+    }
+#endif
+  }
+
+  bool IsAvailable() const { return fFD >= 0; }
+
+  void Start() {
+#ifdef __linux__
+    if (fFD >= 0) {
+      ioctl(fFD, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fFD, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  long long Stop() {
+    long long count = 0;
+#ifdef __linux__
+    if (fFD >= 0) {
+      ioctl(fFD, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fFD, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+      }
+    }
+#endif
+    return count;
+  }
+
+private:
+  long fFD = -1;
+};
+
+
+//
+// --- Visit patterns and the benchmarks
+//
+
+// A visit: HepEm material-cuts index, e- kinetic energy and the discrete
+// interaction to perform (0: ionisation, 1: bremsstrahlung, -1: none).
+struct Visit {
+  int    fIMC;
+  int    fProcess;
+  double fEKin;
+  double fLogEKin;
+};
+
+// The loaded state, the random engine and thread local data shared by all benchmarks.
+G4HepEmState*  gState  = nullptr;
+BenchRandom*   gRandom = nullptr;
+G4HepEmTLData* gTLData = nullptr;
+// The synthesized state of the currently benchmarked number of couples.
+std::unique_ptr<SynthesizedState> gSynthState;
+
+SynthesizedState* GetSynthesizedState(int numCouples) {
+  if (!gSynthState || gSynthState->GetState()->fData->fTheMatCutData->fNumMatCutData != numCouples) {
+    gSynthState.reset();
+    gSynthState.reset(new SynthesizedState(gState, numCouples));
+  }
+  return gSynthState.get();
+}
+
+// Generates the visits of `numCouples` couples changed after each `burst` visits.
+std::shared_ptr<std::vector<Visit>> GenerateVisits(int numCouples, int numVisits, int burst) {
+  const G4HepEmMatCutData* mcData = gState->fData->fTheMatCutData;
+  const int numSrc = mcData->fNumMatCutData;
+  std::mt19937_64 rng(numCouples*31 + burst);
+  std::uniform_int_distribution<int>     coupleDist(0, numCouples - 1);
+  std::uniform_real_distribution<double> logEKinDist(std::log(1.0E-3), std::log(1.0E+4));
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  auto visits = std::make_shared<std::vector<Visit>>(numVisits);
+  int imc = 0;
+  for (int i=0; i<numVisits; ++i) {
+    if (i % burst == 0) {
+      imc = coupleDist(rng);
+    }
+    Visit& v = (*visits)[i];
+    v.fIMC     = imc;
+    v.fLogEKin = logEKinDist(rng);
+    v.fEKin    = std::exp(v.fLogEKin);
+    // only the kinematically allowed interactions (above the production thresholds)
+    const G4HepEmMCCData& mcc = mcData->fMatCutData[imc % numSrc];
+    const bool isIoni = v.fEKin > 2.0*mcc.fSecElProdCutE;
+    const bool isBrem = v.fEKin > mcc.fSecGamProdCutE;
+    v.fProcess = isIoni && isBrem ? (uniform(rng) < 0.5 ? 0 : 1) : (isIoni ? 0 : (isBrem ? 1 : -1));
+  }
+  return visits;
+}
+
+void BenchLookup(benchmark::State& st, int numCouples, const std::vector<Visit>& visits) {
+  SynthesizedState* synth = GetSynthesizedState(numCouples);
+  const G4HepEmElectronData* elData = synth->GetState()->fData->fTheElectronData;
+  const std::size_t numVisits = visits.size();
+  LLCMissCounter llcMisses;
+  std::size_t i = 0;
+  llcMisses.Start();
+  for (auto _ : st) {
+    const Visit& v = visits[i];
+    benchmark::DoNotOptimize(G4HepEmElectronManager::GetRestRange(elData, v.fIMC, v.fEKin, v.fLogEKin));
+    benchmark::DoNotOptimize(G4HepEmElectronManager::GetRestDEDX(elData, v.fIMC, v.fEKin, v.fLogEKin));
+    benchmark::DoNotOptimize(G4HepEmElectronManager::GetRestMacXSec(elData, v.fIMC, v.fEKin, v.fLogEKin, true));
+    benchmark::DoNotOptimize(G4HepEmElectronManager::GetRestMacXSec(elData, v.fIMC, v.fEKin, v.fLogEKin, false));
+    if (++i == numVisits) {
+      i = 0;
+    }
+  }
+  const long long misses = llcMisses.Stop();
+  st.SetItemsProcessed(st.iterations());
+  st.counters["table_MB"] = synth->GetTableMB();
+  if (llcMisses.IsAvailable()) {
+    st.counters["LLC_misses"] = benchmark::Counter(misses, benchmark::Counter::kAvgIterations);
+  }
+}
+
+void BenchStep(benchmark::State& st, int numCouples, const std::vector<Visit>& visits) {
+  SynthesizedState* synth = GetSynthesizedState(numCouples);
+  G4HepEmData*       hepEmData = synth->GetState()->fData;
+  G4HepEmParameters* hepEmPars = synth->GetState()->fParameters;
+  G4HepEmElectronTrack* theElTrack = gTLData->GetPrimaryElectronTrack();
+  G4HepEmTrack* theTrack = theElTrack->GetTrack();
+  const std::size_t numVisits = visits.size();
+  LLCMissCounter llcMisses;
+  std::size_t i = 0;
+  llcMisses.Start();
+  for (auto _ : st) {
+    const Visit& v = visits[i];
+    // a fresh e- track (as in `ReplayKernels`)
+    theElTrack->ReSet();
+    theTrack->SetCharge(-1.0);
+    theTrack->SetEKin(v.fEKin);
+    theTrack->SetMCIndex(v.fIMC);
+    theTrack->SetDirection(0.0, 0.0, 1.0);
+    theTrack->SetSafety(0.0);
+    theTrack->SetOnBoundary(false);
+    G4HepEmElectronManager::HowFar(hepEmData, hepEmPars, gTLData);
+    benchmark::DoNotOptimize(theTrack->GetGStepLength());
+    if (v.fProcess >= 0) {
+      theTrack->SetWinnerProcessIndex(v.fProcess);
+      G4HepEmElectronManager::PerformDiscrete(hepEmData, hepEmPars, gTLData);
+      benchmark::DoNotOptimize(theTrack->GetEKin());
+      gTLData->ResetNumSecondaryElectronTrack();
+      gTLData->ResetNumSecondaryGammaTrack();
+    }
+    if (++i == numVisits) {
+      i = 0;
+    }
+  }
+  const long long misses = llcMisses.Stop();
+  st.SetItemsProcessed(st.iterations());
+  st.counters["table_MB"] = synth->GetTableMB();
+  if (llcMisses.IsAvailable()) {
+    st.counters["LLC_misses"] = benchmark::Counter(misses, benchmark::Counter::kAvgIterations);
+  }
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+  std::string stateFile;
+  if (!PopOption(argc, argv, "state", stateFile)) {
+    std::cerr << " *** ERROR in FootprintScaling: the G4HepEm state JSON file must be given by --state=<file.json>"
+              << std::endl;
+    return 1;
+  }
+  std::string couplesStr = "1,10,100,1000,5000,20000";
+  PopOption(argc, argv, "couples", couplesStr);
+  std::string optStr;
+  int numVisits = 65536;
+  if (PopOption(argc, argv, "visits", optStr)) {
+    numVisits = std::max(1, std::stoi(optStr));
+  }
+  int burst = 16;
+  if (PopOption(argc, argv, "burst", optStr)) {
+    burst = std::max(1, std::stoi(optStr));
+  }
+
+  gState  = LoadState(stateFile);
+  gRandom = new BenchRandom;
+  gTLData = new G4HepEmTLData;
+  gTLData->SetRandomEngine(gRandom->GetEngine());
+
+  // the benchmarks of the same number of couples are registered (i.e. executed)
+  // one after the other so the data are synthesized only once
+  std::stringstream ss(couplesStr);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    const int numCouples = std::stoi(item);
+    if (numCouples < 1) {
+      continue;
+    }
+    const struct { const char* fName; int fBurst; } patterns[] = {{"random", 1}, {"burst", burst}};
+    for (const auto& pattern : patterns) {
+      const std::shared_ptr<std::vector<Visit>> visits = GenerateVisits(numCouples, numVisits, pattern.fBurst);
+      const std::string suffix = std::string("/") + pattern.fName + "/couples:" + std::to_string(numCouples);
+      benchmark::RegisterBenchmark(("Lookup" + suffix).c_str(), [numCouples, visits](benchmark::State& st) {
+        BenchLookup(st, numCouples, *visits);
+      });
+      benchmark::RegisterBenchmark(("Step" + suffix).c_str(), [numCouples, visits](benchmark::State& st) {
+        BenchStep(st, numCouples, *visits);
+      });
+    }
+  }
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::AddCustomContext("g4hepem_state", stateFile);
+  benchmark::AddCustomContext("g4hepem_num_state_couples",
+                              std::to_string(gState->fData->fTheMatCutData->fNumMatCutData));
+  benchmark::AddCustomContext("g4hepem_visits", std::to_string(numVisits));
+  benchmark::AddCustomContext("g4hepem_burst", std::to_string(burst));
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  gSynthState.reset();
+  delete gTLData;
+  delete gRandom;
+  FreeState(gState);
+  return 0;
+}
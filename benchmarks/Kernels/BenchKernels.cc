@@ -0,0 +1,310 @@
+
+// Microbenchmarks of the G4HepEm interaction (final state sampling) and data
+// lookup kernels, per material-cuts couple and primary kinetic energy.
+//
+// The G4HepEm state (data and parameters) is loaded from a JSON file so Geant4
+// is not needed at benchmark time:
+//
+//   BenchKernels --state=<state.json> [--max-couples=N] [benchmark options]
+//
+// All the usual Google Benchmark options are available, e.g. the results can be
+// written in machine readable format by `--benchmark_out=<file.json>` (with the
+// default `--benchmark_out_format=json`) or filtered by `--benchmark_filter=<regex>`.
+
+#include "BenchUtils.hh"
+
+#include "G4HepEmData.hh"
+#include "G4HepEmParameters.hh"
+#include "G4HepEmState.hh"
+#include "G4HepEmMatCutData.hh"
+#include "G4HepEmMaterialData.hh"
+
+#include "G4HepEmElectronManager.hh"
+#include "G4HepEmGammaManager.hh"
+#include "G4HepEmGammaTrack.hh"
+#include "G4HepEmMSCTrackData.hh"
+#include "G4HepEmElectronInteractionBrem.hh"
+#include "G4HepEmElectronInteractionIoni.hh"
+#include "G4HepEmElectronInteractionUMSC.hh"
+#include "G4HepEmElectronEnergyLossFluctuation.hh"
+#include "G4HepEmGammaInteractionCompton.hh"
+#include "G4HepEmGammaInteractionConversion.hh"
+#include "G4HepEmGammaInteractionPhotoelectric.hh"
+#include "G4HepEmPositronInteractionAnnihilation.hh"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The loaded state and the random number engine shared by all benchmarks.
+G4HepEmState* gState  = nullptr;
+BenchRandom*  gRandom = nullptr;
+
+// Signature of a kernel benchmark: state, HepEm material-cuts index and primary energy.
+using KernelBench = std::function<void(benchmark::State&, int, double)>;
+
+// Registers the benchmark `name/imc:<imc>/<ekin>` for all selected couples and
+// for those energies that are accepted by `isValid`.
+void Register(const std::string& name, const KernelBench& bench, const std::vector<double>& energies,
+              int numCouples, const std::function<bool(int, double)>& isValid) {
+  for (int imc=0; imc<numCouples; ++imc) {
+    for (const double ekin : energies) {
+      if (!isValid(imc, ekin)) {
+        continue;
+      }
+      const std::string bname = name + "/imc:" + std::to_string(imc) + "/" + EnergyLabel(ekin);
+      benchmark::RegisterBenchmark(bname.c_str(), [bench, imc, ekin](benchmark::State& st) {
+        bench(st, imc, ekin);
+        st.SetItemsProcessed(st.iterations());
+      });
+    }
+  }
+}
+
+bool Always(int, double) { return true; }
+
+const G4HepEmMCCData& MCCData(int imc) {
+  return gState->fData->fTheMatCutData->fMatCutData[imc];
+}
+
+const G4HepEmMatData& MatData(int imc) {
+  return gState->fData->fTheMaterialData->fMaterialData[MCCData(imc).fHepEmMatIndex];
+}
+
+
+//
+// --- Interaction kernels
+//
+void BenchBremSB(benchmark::State& st, int imc, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const double lekin = std::log(ekin);
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmElectronInteractionBrem::SampleETransferSB(gState->fData, ekin, lekin, imc, rnge, true));
+  }
+}
+
+void BenchBremRB(benchmark::State& st, int imc, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const double lekin = std::log(ekin);
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmElectronInteractionBrem::SampleETransferRB(gState->fData, ekin, lekin, imc, rnge, true));
+  }
+}
+
+void BenchMoller(benchmark::State& st, int imc, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const double elCut = MCCData(imc).fSecElProdCutE;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmElectronInteractionIoni::SampleETransferMoller(elCut, ekin, rnge));
+  }
+}
+
+void BenchBhabha(benchmark::State& st, int imc, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const double elCut = MCCData(imc).fSecElProdCutE;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmElectronInteractionIoni::SampleETransferBhabha(elCut, ekin, rnge));
+  }
+}
+
+void BenchCompton(benchmark::State& st, int, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const double orgDir[3] = {0.0, 0.0, 1.0};
+  double newDir[3];
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmGammaInteractionCompton::SamplePhotonEnergyAndDirection(ekin, newDir, orgDir, rnge));
+    benchmark::DoNotOptimize(newDir);
+  }
+}
+
+void BenchConversion(benchmark::State& st, int imc, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const double lekin = std::log(ekin);
+  double eKinEnergy, pKinEnergy;
+  for (auto _ : st) {
+    G4HepEmGammaInteractionConversion::SampleKinEnergies(gState->fData, ekin, lekin, imc, eKinEnergy, pKinEnergy, rnge);
+    benchmark::DoNotOptimize(eKinEnergy);
+    benchmark::DoNotOptimize(pKinEnergy);
+  }
+}
+
+void BenchPhotoelectric(benchmark::State& st, int imc, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const double mxsec = G4HepEmGammaManager::GetMacXSecPE(gState->fData, MCCData(imc).fHepEmMatIndex, ekin);
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmGammaInteractionPhotoelectric::SelectElementBindingEnergy(gState->fData, imc, mxsec, ekin, rnge));
+  }
+}
+
+void BenchAnnihilation(benchmark::State& st, int, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const double primDir[3] = {0.0, 0.0, 1.0};
+  double gamma1Ekin, gamma2Ekin, gamma1Dir[3], gamma2Dir[3];
+  for (auto _ : st) {
+    G4HepEmPositronInteractionAnnihilation::SampleEnergyAndDirectionsInFlight(ekin, primDir, &gamma1Ekin, gamma1Dir,
+                                                                              &gamma2Ekin, gamma2Dir, rnge);
+    benchmark::DoNotOptimize(gamma1Ekin);
+    benchmark::DoNotOptimize(gamma2Dir);
+  }
+}
+
+// Urban MSC angular deflection and displacement sampling of e- in a step of
+// 10 % of the first transport mean free path (limited by 10 % of the range).
+void BenchUrbanMSC(benchmark::State& st, int imc, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const G4HepEmElectronData* elData = gState->fData->fTheElectronData;
+  const int    imat     = MCCData(imc).fHepEmMatIndex;
+  const double lekin    = std::log(ekin);
+  const double range    = G4HepEmElectronManager::GetRestRange(elData, imc, ekin, lekin);
+  const double preTr1   = G4HepEmElectronManager::GetTransportMFP(elData, imat, ekin, lekin);
+  const double pStep    = std::fmin(0.1*preTr1, 0.1*range);
+  const double postEkin = std::fmax(ekin - pStep*G4HepEmElectronManager::GetRestDEDX(elData, imc, ekin, lekin), 0.5*ekin);
+  const double postTr1  = G4HepEmElectronManager::GetTransportMFP(elData, imat, postEkin, std::log(postEkin));
+  const bool   isPosCor = gState->fParameters->fIsMSCPositronCor;
+  G4HepEmMSCTrackData mscData;
+  for (auto _ : st) {
+    mscData.fLambtr1     = preTr1;
+    mscData.fZPathLength = 0.9*pStep;
+    mscData.fTlimitMin   = 1.0E-5;
+    mscData.fIsDisplace  = true;
+    G4HepEmElectronInteractionUMSC::SampleScattering(gState->fData, &mscData, pStep, ekin, preTr1, postEkin, postTr1,
+                                                     imat, true, isPosCor, rnge);
+    benchmark::DoNotOptimize(mscData.fDirection);
+    benchmark::DoNotOptimize(mscData.fDisplacement);
+  }
+}
+
+// Energy loss fluctuation of e- in a step of 5 % of the range.
+void BenchELossFluctuation(benchmark::State& st, int imc, double ekin) {
+  G4HepEmRandomEngine* rnge = gRandom->GetEngine();
+  const G4HepEmElectronData* elData = gState->fData->fTheElectronData;
+  const double lekin     = std::log(ekin);
+  const double step      = 0.05*G4HepEmElectronManager::GetRestRange(elData, imc, ekin, lekin);
+  const double meanELoss = step*G4HepEmElectronManager::GetRestDEDX(elData, imc, ekin, lekin);
+  const double tmax      = 0.5*ekin;
+  const double tcut      = std::fmin(MCCData(imc).fSecElProdCutE, tmax);
+  const double meanExE   = MatData(imc).fMeanExEnergy;
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmElectronEnergyLossFluctuation::SampleEnergyLossFLuctuation(ekin, tcut, tmax, meanExE,
+                                                                                              step, meanELoss, rnge));
+  }
+}
+
+
+//
+// --- Data lookup kernels
+//
+void BenchRestRange(benchmark::State& st, int imc, double ekin) {
+  const G4HepEmElectronData* elData = gState->fData->fTheElectronData;
+  const double lekin = std::log(ekin);
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmElectronManager::GetRestRange(elData, imc, ekin, lekin));
+  }
+}
+
+void BenchRestMacXSecIoni(benchmark::State& st, int imc, double ekin) {
+  const G4HepEmElectronData* elData = gState->fData->fTheElectronData;
+  const double lekin = std::log(ekin);
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmElectronManager::GetRestMacXSec(elData, imc, ekin, lekin, true));
+  }
+}
+
+void BenchRestMacXSecBrem(benchmark::State& st, int imc, double ekin) {
+  const G4HepEmElectronData* elData = gState->fData->fTheElectronData;
+  const double lekin = std::log(ekin);
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmElectronManager::GetRestMacXSec(elData, imc, ekin, lekin, false));
+  }
+}
+
+void BenchTotalMacXSecGamma(benchmark::State& st, int imc, double ekin) {
+  G4HepEmGammaTrack gammaTrack;
+  G4HepEmTrack* theTrack = gammaTrack.GetTrack();
+  theTrack->SetEKin(ekin, std::log(ekin));
+  theTrack->SetMCIndex(imc);
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(G4HepEmGammaManager::GetTotalMacXSec(gState->fData, &gammaTrack));
+  }
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+  std::string stateFile;
+  if (!PopOption(argc, argv, "state", stateFile)) {
+    std::cerr << " *** ERROR in BenchKernels: the G4HepEm state JSON file must be given by --state=<file.json> "
+              << std::endl;
+    return 1;
+  }
+  std::string maxCouples;
+  PopOption(argc, argv, "max-couples", maxCouples);
+
+  gState  = LoadState(stateFile);
+  gRandom = new BenchRandom;
+
+  int numCouples = gState->fData->fTheMatCutData->fNumMatCutData;
+  if (!maxCouples.empty()) {
+    numCouples = std::min(numCouples, std::atoi(maxCouples.c_str()));
+  }
+
+  // The primary energies [MeV] and their validity for the given kernels.
+  const double bremModelLim = gState->fParameters->fElectronBremModelLim;
+  const std::vector<double> elEnergies  = {1.0, 10.0, 100.0, 1000.0};
+  const std::vector<double> rbEnergies  = {1.0E+4, 1.0E+6};
+  const std::vector<double> gmEnergies  = {0.1, 1.0, 10.0, 100.0};
+  const std::vector<double> convEnergies= {5.0, 50.0, 1000.0, 1.0E+5};
+  const std::vector<double> peEnergies  = {0.01, 0.05, 0.1};
+  const std::vector<double> lkEnergies  = {0.01, 1.0, 100.0, 1.0E+4};
+
+  Register("Brem-SB", BenchBremSB, elEnergies, numCouples, [bremModelLim](int imc, double ekin) {
+    return ekin < bremModelLim && ekin > MCCData(imc).fSecGamProdCutE;
+  });
+  Register("Brem-RB", BenchBremRB, rbEnergies, numCouples, [bremModelLim](int imc, double ekin) {
+    return ekin >= bremModelLim && ekin > MCCData(imc).fSecGamProdCutE;
+  });
+  Register("Moller", BenchMoller, elEnergies, numCouples, [](int imc, double ekin) {
+    return ekin > 2.0*MCCData(imc).fSecElProdCutE;
+  });
+  Register("Bhabha", BenchBhabha, elEnergies, numCouples, [](int imc, double ekin) {
+    return ekin > MCCData(imc).fSecElProdCutE;
+  });
+  // Compton and annihilation do not depend on the material: only the first couple
+  Register("Compton",      BenchCompton,       gmEnergies,   1, Always);
+  Register("Annihilation", BenchAnnihilation,  elEnergies,   1, Always);
+  Register("Conversion",   BenchConversion,    convEnergies, numCouples, Always);
+  Register("Photoelectric",BenchPhotoelectric, peEnergies,   numCouples, Always);
+  Register("UrbanMSC",     BenchUrbanMSC,      elEnergies,   numCouples, Always);
+  Register("ELossFluct",   BenchELossFluctuation, elEnergies, numCouples, Always);
+
+  Register("GetRestRange",        BenchRestRange,         lkEnergies, numCouples, Always);
+  Register("GetRestMacXSec-Ioni", BenchRestMacXSecIoni,   lkEnergies, numCouples, [](int imc, double ekin) {
+    return ekin > 2.0*MCCData(imc).fSecElProdCutE;
+  });
+  Register("GetRestMacXSec-Brem", BenchRestMacXSecBrem,   lkEnergies, numCouples, [](int imc, double ekin) {
+    return ekin > MCCData(imc).fSecGamProdCutE;
+  });
+  Register("GetTotalMacXSec",     BenchTotalMacXSecGamma, lkEnergies, numCouples, Always);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::AddCustomContext("g4hepem_state", stateFile);
+  benchmark::AddCustomContext("g4hepem_num_couples", std::to_string(numCouples));
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  delete gRandom;
+  FreeState(gState);
+  return 0;
+}
@@ -0,0 +1,221 @@
+
+// Replays the kernel input records, captured from a real application by the
+// recording mode of the `G4HepEmTrackingManager` (see `G4HepEmKernelRecorder`),
+// through the G4HepEm `HowFar` and `Perform` kernels and reports their throughput.
+//
+// The G4HepEm state (data and parameters) is loaded from the `<name>.state.json`
+// file written alongside the records so Geant4 is not needed at replay time:
+//
+//   ReplayKernels --state=<name.state.json> --records=<name.t0.bin[,name.t1.bin,...]>
+//                 [--max-records=N] [benchmark options]
+//
+// The `Replay/all` benchmark feeds the records in their recorded order (i.e.
+// with the real mix of particles, materials, energies and kernels) while the
+// `Replay/<particle>/<kernel>` benchmarks use only the corresponding subset.
+// Each iteration is one kernel call, i.e. `items_per_second` is the number of
+// replayed records per second.
+
+#include "BenchUtils.hh"
+
+#include "G4HepEmData.hh"
+#include "G4HepEmParameters.hh"
+#include "G4HepEmState.hh"
+#include "G4HepEmMatCutData.hh"
+#include "G4HepEmKernelRecord.hh"
+
+#include "G4HepEmTLData.hh"
+#include "G4HepEmElectronManager.hh"
+#include "G4HepEmElectronTrack.hh"
+#include "G4HepEmGammaManager.hh"
+#include "G4HepEmGammaTrack.hh"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A replayed record: the record itself and the direction (+z if not recorded).
+struct ReplayRecord {
+  G4HepEmKernelRecord fRecord;
+  double              fDirection[3];
+};
+
+// The loaded state, records and the thread local data (with the random engine)
+// shared by all benchmarks.
+G4HepEmState*             gState  = nullptr;
+BenchRandom*              gRandom = nullptr;
+G4HepEmTLData*            gTLData = nullptr;
+std::vector<ReplayRecord> gRecords;
+
+const char* const kParticleNames[] = {"e-", "e+", "gamma"};
+const char* const kKernelNames[]   = {"HowFar", "Perform"};
+
+// Appends the records of the given file to `gRecords` (stops at `maxRecords`).
+// Stops the application if the file cannot be read or its format is unknown.
+void ReadRecords(const std::string& fileName, std::size_t maxRecords) {
+  std::ifstream inf(fileName, std::ios::binary);
+  G4HepEmKernelRecordHeader header;
+  const G4HepEmKernelRecordHeader expected;
+  if (!inf || !inf.read(reinterpret_cast<char*>(&header), sizeof(header))
+      || std::memcmp(header.fMagic, expected.fMagic, sizeof(header.fMagic)) != 0
+      || header.fVersion != expected.fVersion) {
+    std::cerr << " *** ERROR in ReplayKernels: cannot read the kernel records from file = "
+              << fileName << std::endl;
+    exit(1);
+  }
+  const bool isWithDirection = (header.fFlags & G4HepEmKernelRecordHeader::kIsWithDirection) != 0;
+  ReplayRecord rec;
+  float dir[3] = {0.0f, 0.0f, 1.0f};
+  while (gRecords.size() < maxRecords && inf.read(reinterpret_cast<char*>(&rec.fRecord), sizeof(rec.fRecord))) {
+    if (isWithDirection && !inf.read(reinterpret_cast<char*>(dir), sizeof(dir))) {
+      break;
+    }
+    for (int i=0; i<3; ++i) {
+      rec.fDirection[i] = dir[i];
+    }
+    gRecords.push_back(rec);
+  }
+}
+
+// Feeds a single record through the corresponding kernel.
+void Replay(const ReplayRecord& rec) {
+  G4HepEmData*       hepEmData = gState->fData;
+  G4HepEmParameters* hepEmPars = gState->fParameters;
+  const G4HepEmKernelRecord& r = rec.fRecord;
+  if (r.fParticle < 2) {
+    G4HepEmElectronTrack* theElTrack = gTLData->GetPrimaryElectronTrack();
+    G4HepEmTrack* theTrack = theElTrack->GetTrack();
+    theElTrack->ReSet();
+    theTrack->SetCharge(r.fParticle == 0 ? -1.0 : 1.0);
+    theTrack->SetEKin(r.fEKin);
+    theTrack->SetMCIndex(r.fHepEmIMC);
+    theTrack->SetDirection(rec.fDirection[0], rec.fDirection[1], rec.fDirection[2]);
+    if (r.fKernel == G4HepEmKernelRecord::kHowFar) {
+      theTrack->SetSafety(r.fSafety);
+      theTrack->SetOnBoundary((r.fFlags & G4HepEmKernelRecord::kOnBoundary) != 0);
+      G4HepEmElectronManager::HowFar(hepEmData, hepEmPars, gTLData);
+      benchmark::DoNotOptimize(theTrack->GetGStepLength());
+    } else {
+      theTrack->SetWinnerProcessIndex(r.fProcess);
+      theTrack->SetOnBoundary(false);
+      G4HepEmElectronManager::PerformDiscrete(hepEmData, hepEmPars, gTLData);
+      benchmark::DoNotOptimize(theTrack->GetEKin());
+    }
+  } else {
+    G4HepEmGammaTrack* theGammaTrack = gTLData->GetPrimaryGammaTrack();
+    G4HepEmTrack* theTrack = theGammaTrack->GetTrack();
+    theGammaTrack->ReSet();
+    theTrack->SetEKin(r.fEKin);
+    theTrack->SetMCIndex(r.fHepEmIMC);
+    theTrack->SetDirection(rec.fDirection[0], rec.fDirection[1], rec.fDirection[2]);
+    if (r.fKernel == G4HepEmKernelRecord::kHowFar) {
+      theTrack->SetOnBoundary((r.fFlags & G4HepEmKernelRecord::kOnBoundary) != 0);
+      G4HepEmGammaManager::HowFar(hepEmData, hepEmPars, gTLData);
+      benchmark::DoNotOptimize(theTrack->GetGStepLength());
+    } else {
+      // the macroscopic cross sections are needed (as set by `HowFar` in the tracking)
+      theTrack->SetMFP(1.0/G4HepEmGammaManager::GetTotalMacXSec(hepEmData, theGammaTrack), 0);
+      theTrack->SetWinnerProcessIndex(r.fProcess);
+      theTrack->SetOnBoundary(false);
+      G4HepEmGammaManager::Perform(hepEmData, hepEmPars, gTLData);
+      benchmark::DoNotOptimize(theTrack->GetEKin());
+    }
+  }
+  gTLData->ResetNumSecondaryElectronTrack();
+  gTLData->ResetNumSecondaryGammaTrack();
+}
+
+// Registers the benchmark that replays the records of the given indices (in order).
+void Register(const std::string& name, const std::vector<std::size_t>& indices) {
+  if (indices.empty()) {
+    return;
+  }
+  benchmark::RegisterBenchmark(name.c_str(), [indices](benchmark::State& st) {
+    const std::size_t num = indices.size();
+    std::size_t i = 0;
+    for (auto _ : st) {
+      Replay(gRecords[indices[i]]);
+      if (++i == num) {
+        i = 0;
+      }
+    }
+    st.SetItemsProcessed(st.iterations());
+  });
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+  std::string stateFile;
+  std::string recordFiles;
+  if (!PopOption(argc, argv, "state", stateFile) || !PopOption(argc, argv, "records", recordFiles)) {
+    std::cerr << " *** ERROR in ReplayKernels: the G4HepEm state JSON and the kernel record files must be given by "
+              << "--state=<file.json> --records=<file.bin[,file.bin,...]> " << std::endl;
+    return 1;
+  }
+  std::string maxRecordsStr;
+  std::size_t maxRecords = static_cast<std::size_t>(-1);
+  if (PopOption(argc, argv, "max-records", maxRecordsStr)) {
+    maxRecords = std::stoull(maxRecordsStr);
+  }
+
+  gState  = LoadState(stateFile);
+  gRandom = new BenchRandom;
+  gTLData = new G4HepEmTLData;
+  gTLData->SetRandomEngine(gRandom->GetEngine());
+
+  std::stringstream ss(recordFiles);
+  std::string fileName;
+  while (std::getline(ss, fileName, ',')) {
+    ReadRecords(fileName, maxRecords);
+  }
+  // Skip the records that cannot be replayed by the HepEm kernels (e.g.
+  // lepto/photo-nuclear interactions handled by Geant4) or that do not
+  // belong to the loaded state.
+  const int numHepEmMatCuts = gState->fData->fTheMatCutData->fNumMatCutData;
+  std::vector<std::size_t> all;
+  std::vector<std::size_t> perParticleKernel[3][2];
+  for (std::size_t i=0; i<gRecords.size(); ++i) {
+    const G4HepEmKernelRecord& r = gRecords[i].fRecord;
+    if (r.fParticle > 2 || r.fKernel > 1 || r.fHepEmIMC < 0 || r.fHepEmIMC >= numHepEmMatCuts
+        || (r.fKernel == G4HepEmKernelRecord::kPerform && (r.fProcess < 0 || r.fProcess > 2))) {
+      continue;
+    }
+    all.push_back(i);
+    perParticleKernel[r.fParticle][r.fKernel].push_back(i);
+  }
+  if (all.empty()) {
+    std::cerr << " *** ERROR in ReplayKernels: no records to replay in " << recordFiles << std::endl;
+    return 1;
+  }
+
+  Register("Replay/all", all);
+  for (int ip=0; ip<3; ++ip) {
+    for (int ik=0; ik<2; ++ik) {
+      Register(std::string("Replay/") + kParticleNames[ip] + "/" + kKernelNames[ik], perParticleKernel[ip][ik]);
+    }
+  }
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::AddCustomContext("g4hepem_state", stateFile);
+  benchmark::AddCustomContext("g4hepem_records", recordFiles);
+  benchmark::AddCustomContext("g4hepem_num_records", std::to_string(all.size()));
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  delete gTLData;
+  delete gRandom;
+  FreeState(gState);
+  return 0;
+}
@@ -0,0 +1,221 @@
+
+// G4 includes
+#include "globals.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Electron.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4StepStatus.hh"
+#include "G4Track.hh"
+#include "G4TouchableHandle.hh"
+#include "G4TouchableHistory.hh"
+#include "G4VSensitiveDetector.hh"
+
+// G4HepEm includes
+#include "G4HepEmHitAggregator.hh"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// A hit as seen by the SD.
+struct RecordedHit {
+  std::string fSD;
+  G4double    fEdep;
+  G4double    fStepLength;
+  G4double    fPreZ;
+  G4double    fPostZ;
+};
+
+// A sensitive detector that records all the hits (in order, shared by all SDs).
+class RecordingSD : public G4VSensitiveDetector {
+public:
+  RecordingSD(const G4String& name, std::vector<RecordedHit>& hits)
+  : G4VSensitiveDetector(name), fHits(hits) {}
+
+  G4bool ProcessHits(G4Step* step, G4TouchableHistory*) override {
+    fHits.push_back({GetName(), step->GetTotalEnergyDeposit(), step->GetStepLength(),
+                     step->GetPreStepPoint()->GetPosition().z(), step->GetPostStepPoint()->GetPosition().z()});
+    return true;
+  }
+
+private:
+  std::vector<RecordedHit>& fHits;
+};
+
+// Sets the step: track, touchables (pre-step point in `preTouch`, post-step
+// point in `postTouch`), positions along z, edep and the post-step status.
+static void SetStep(G4Step& step, G4Track* track, const G4TouchableHandle& preTouch,
+                    const G4TouchableHandle& postTouch, G4double z0, G4double z1,
+                    G4double edep, G4StepStatus postStatus) {
+  step.SetTrack(track);
+  step.GetPreStepPoint()->SetTouchableHandle(preTouch);
+  step.GetPreStepPoint()->SetPosition(G4ThreeVector(0.0, 0.0, z0));
+  step.GetPostStepPoint()->SetTouchableHandle(postTouch);
+  step.GetPostStepPoint()->SetPosition(G4ThreeVector(0.0, 0.0, z1));
+  step.GetPostStepPoint()->SetStepStatus(postStatus);
+  step.SetStepLength(z1 - z0);
+  step.ResetTotalEnergyDeposit();
+  step.AddTotalEnergyDeposit(edep);
+}
+
+static bool CheckHit(const std::string& testName, const std::vector<RecordedHit>& hits, std::size_t indx,
+                     const std::string& sd, G4double edep, G4double stepLength, G4double preZ, G4double postZ) {
+  if (indx >= hits.size()) {
+    std::cerr << " *** " << testName << ": hit #" << indx << " is missing (" << hits.size() << " hits)" << std::endl;
+    return false;
+  }
+  const RecordedHit& h = hits[indx];
+  const G4double eps = 1.0E-12;
+  if (h.fSD != sd || std::abs(h.fEdep - edep) > eps || std::abs(h.fStepLength - stepLength) > eps ||
+      std::abs(h.fPreZ - preZ) > eps || std::abs(h.fPostZ - postZ) > eps) {
+    std::cerr << " *** " << testName << ": hit #" << indx << " = {" << h.fSD << ", " << h.fEdep << ", "
+              << h.fStepLength << ", " << h.fPreZ << ", " << h.fPostZ << "} while expected {" << sd << ", "
+              << edep << ", " << stepLength << ", " << preZ << ", " << postZ << "}" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+static bool CheckNumHits(const std::string& testName, const std::vector<RecordedHit>& hits, std::size_t num) {
+  if (hits.size() != num) {
+    std::cerr << " *** " << testName << ": " << hits.size() << " hits while expected " << num << std::endl;
+    return false;
+  }
+  return true;
+}
+
+
+int main() {
+  std::vector<RecordedHit> hits;
+  RecordingSD sdA("sdA", hits);
+  RecordingSD sdB("sdB", hits);
+
+  G4Track* track1 = new G4Track(new G4DynamicParticle(G4Electron::Definition(), G4ThreeVector(0, 0, 1), 1.0*MeV),
+                                0.0, G4ThreeVector());
+  G4Track* track2 = new G4Track(new G4DynamicParticle(G4Electron::Definition(), G4ThreeVector(0, 0, 1), 1.0*MeV),
+                                0.0, G4ThreeVector());
+  track1->SetTrackStatus(fAlive);
+  track2->SetTrackStatus(fAlive);
+  G4TouchableHandle touch1(new G4TouchableHistory);
+  G4TouchableHandle touch2(new G4TouchableHistory);
+
+  G4HepEmHitAggregator aggregator;
+  G4Step step;
+  bool isOK = true;
+
+  // 1. Same SD, track and touchable: merged until the boundary is reached.
+  {
+    const std::string name = "same touchable, flush at boundary";
+    hits.clear();
+    SetStep(step, track1, touch1, touch1, 0.0, 1.0, 0.1, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    SetStep(step, track1, touch1, touch1, 1.0, 3.0, 0.2, fPostStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    isOK &= CheckNumHits(name + " (pending)", hits, 0);
+    SetStep(step, track1, touch1, touch2, 3.0, 4.0, 0.3, fGeomBoundary);
+    aggregator.Invoke(&sdA, step, true);
+    isOK &= CheckNumHits(name, hits, 1) && CheckHit(name, hits, 0, "sdA", 0.6, 4.0, 0.0, 4.0);
+    isOK &= !aggregator.IsPending();
+  }
+
+  // 2. Flush when the track dies.
+  {
+    const std::string name = "flush at the end of the track";
+    hits.clear();
+    SetStep(step, track1, touch1, touch1, 0.0, 1.0, 0.1, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    track1->SetTrackStatus(fStopAndKill);
+    SetStep(step, track1, touch1, touch1, 1.0, 1.5, 0.4, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    track1->SetTrackStatus(fAlive);
+    isOK &= CheckNumHits(name, hits, 1) && CheckHit(name, hits, 0, "sdA", 0.5, 1.5, 0.0, 1.5);
+  }
+
+  // 3. A step starting in another touchable is not merged.
+  {
+    const std::string name = "different touchable";
+    hits.clear();
+    SetStep(step, track1, touch1, touch1, 0.0, 1.0, 0.1, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    SetStep(step, track1, touch2, touch2, 1.0, 2.0, 0.2, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    aggregator.Flush();
+    isOK &= CheckNumHits(name, hits, 2) && CheckHit(name, hits, 0, "sdA", 0.1, 1.0, 0.0, 1.0)
+            && CheckHit(name, hits, 1, "sdA", 0.2, 1.0, 1.0, 2.0);
+  }
+
+  // 4. A step of another track is not merged.
+  {
+    const std::string name = "different track";
+    hits.clear();
+    SetStep(step, track1, touch1, touch1, 0.0, 1.0, 0.1, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    SetStep(step, track2, touch1, touch1, 1.0, 2.0, 0.2, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    aggregator.Flush();
+    isOK &= CheckNumHits(name, hits, 2) && CheckHit(name, hits, 0, "sdA", 0.1, 1.0, 0.0, 1.0)
+            && CheckHit(name, hits, 1, "sdA", 0.2, 1.0, 1.0, 2.0);
+  }
+
+  // 5. A step with another SD is not merged.
+  {
+    const std::string name = "different SD";
+    hits.clear();
+    SetStep(step, track1, touch1, touch1, 0.0, 1.0, 0.1, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    SetStep(step, track1, touch1, touch1, 1.0, 2.0, 0.2, fAlongStepDoItProc);
+    aggregator.Invoke(&sdB, step, true);
+    aggregator.Flush();
+    isOK &= CheckNumHits(name, hits, 2) && CheckHit(name, hits, 0, "sdA", 0.1, 1.0, 0.0, 1.0)
+            && CheckHit(name, hits, 1, "sdB", 0.2, 1.0, 1.0, 2.0);
+  }
+
+  // 6. A step that is not aggregated: the pending one goes first (order kept).
+  {
+    const std::string name = "not aggregated step";
+    hits.clear();
+    SetStep(step, track1, touch1, touch1, 0.0, 1.0, 0.1, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    SetStep(step, track1, touch1, touch1, 1.0, 2.0, 0.2, fAlongStepDoItProc);
+    aggregator.Invoke(&sdB, step, false);
+    isOK &= CheckNumHits(name, hits, 2) && CheckHit(name, hits, 0, "sdA", 0.1, 1.0, 0.0, 1.0)
+            && CheckHit(name, hits, 1, "sdB", 0.2, 1.0, 1.0, 2.0);
+    isOK &= !aggregator.IsPending();
+  }
+
+  // 7. A step with another pre-step weight (e.g. changed by leading particle
+  //    biasing in the previous step) is not merged.
+  {
+    const std::string name = "different weight";
+    hits.clear();
+    SetStep(step, track1, touch1, touch1, 0.0, 1.0, 0.1, fAlongStepDoItProc);
+    aggregator.Invoke(&sdA, step, true);
+    SetStep(step, track1, touch1, touch1, 1.0, 2.0, 0.2, fAlongStepDoItProc);
+    step.GetPreStepPoint()->SetWeight(2.0);
+    aggregator.Invoke(&sdA, step, true);
+    aggregator.Flush();
+    step.GetPreStepPoint()->SetWeight(1.0);
+    isOK &= CheckNumHits(name, hits, 2) && CheckHit(name, hits, 0, "sdA", 0.1, 1.0, 0.0, 1.0)
+            && CheckHit(name, hits, 1, "sdA", 0.2, 1.0, 1.0, 2.0);
+  }
+
+  // 8. Nothing is handed over by flushing without a pending step.
+  {
+    const std::string name = "empty flush";
+    hits.clear();
+    aggregator.Flush();
+    isOK &= CheckNumHits(name, hits, 0);
+  }
+
+  delete track1;
+  delete track2;
+
+  if (!isOK) {
+    std::cerr << " *** TestHitAggregation: FAILED" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,237 @@
+
+// local (and TestUtils) includes
+#include "TestUtils/G4SetUp.hh"
+
+// G4 includes
+#include "globals.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+// G4HepEm includes
+#include "G4HepEmRunManager.hh"
+#include "G4HepEmRandomEngine.hh"
+#include "G4HepEmData.hh"
+#include "G4HepEmParameters.hh"
+#include "G4HepEmMatCutData.hh"
+#include "G4HepEmParametersInit.hh"
+#include "G4HepEmMaterialInit.hh"
+#include "G4HepEmElectronInit.hh"
+#include "G4HepEmGammaInit.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <err.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+//
+// Benchmark of the G4HepEm initialisation: the data initialisation done by
+// `G4HepEmRunManager::Initialize` (i.e. by `G4HepEmMaterialInit`,
+// `G4HepEmElectronInit` and `G4HepEmGammaInit`) is executed step by step while
+// measuring the wall-clock time and the resident memory of its stages (through
+// the stage hook of `InitElectronData` and `InitGammaData`). The total time of the complete
+// `G4HepEmRunManager::Initialize` (all the 3 particles) is also measured as a
+// reference. The fake geometry is built by `FakeG4SetupWithCouples` with the
+// required number of material-cuts couples.
+//
+// Since the Geant4 geometry cannot be rebuilt, a single number of couples is
+// benchmarked by one invocation (e.g. loop over 10 - 10000 in a script).
+//
+
+static struct option options[] = {
+    {"num-couples  (number of material-cuts couples)      - default: 300",  required_argument, 0, 'n'},
+    {"cut-value    (secondary prod. thresh. in [mm])      - default: 0.7",  required_argument, 0, 'c'},
+    {"json-file    (write the results in JSON format)     - default: none", required_argument, 0, 'j'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}};
+
+static void Help() {
+  std::cout<<"\n "<<std::setw(100)<<std::setfill('=')<<""<<std::setfill(' ')<<std::endl;
+  std::cout<<"  InitBenchmark: per stage time and memory of the G4HepEm initialisation"<<std::endl;
+  std::cout<<"\n  Usage: InitBenchmark [OPTIONS] \n"<<std::endl;
+  for (int i = 0; options[i].name != NULL; i++) {
+    printf("\t-%c  --%s\n", options[i].val, options[i].name);
+  }
+  std::cout<<"\n "<<std::setw(100)<<std::setfill('=')<<""<<std::setfill(' ')<<std::endl;
+}
+
+
+// Resident (current) and peak resident memory of the process in [MB].
+static double GetRSSMB() {
+  long pages = 0;
+  FILE* fp = fopen("/proc/self/statm", "r");
+  if (fp != nullptr) {
+    if (fscanf(fp, "%*s %ld", &pages) != 1) {
+      pages = 0;
+    }
+    fclose(fp);
+  }
+  return pages*static_cast<double>(sysconf(_SC_PAGESIZE))/(1024.0*1024.0);
+}
+
+static double GetPeakRSSMB() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  // `ru_maxrss` is given in [kB] on Linux
+  return usage.ru_maxrss/1024.0;
+}
+
+
+// Measures the time and the memory change of the stages.
+struct Stage {
+  std::string fName;
+  double      fTime;    // [s]
+  double      fDRSS;    // [MB]
+};
+
+class StageTimer {
+public:
+  void Start() {
+    fRSS   = GetRSSMB();
+    fStart = std::chrono::steady_clock::now();
+  }
+  void Stop(const std::string& name) {
+    const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - fStart).count();
+    fStages.push_back({name, time, GetRSSMB() - fRSS});
+  }
+  const std::vector<Stage>& GetStages() const { return fStages; }
+
+private:
+  std::chrono::steady_clock::time_point fStart;
+  double                                fRSS = 0.0;
+  std::vector<Stage>                    fStages;
+};
+
+
+// The stage hook of `InitElectronData` and `InitGammaData`: the stages are
+// measured by the `StageTimer` with the particle name prefixed to their names.
+struct StageHookData {
+  StageTimer* fTimer;
+  std::string fParticle;
+};
+
+static void StageHook(const char* stageName, bool isBegin, void* userData) {
+  StageHookData* data = static_cast<StageHookData*>(userData);
+  if (isBegin) {
+    data->fTimer->Start();
+  } else {
+    data->fTimer->Stop(data->fParticle + " " + stageName);
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  G4int    numCouples = 300;
+  G4double cutValue   = 0.7*mm;
+  std::string jsonFile;
+  while (true) {
+    int c, optidx = 0;
+    c = getopt_long(argc, argv, "n:c:j:h", options, &optidx);
+    if (c == -1) break;
+    switch (c) {
+    case 'n':
+      numCouples = (int)strtod(optarg, NULL);
+      if (numCouples < 1) {
+        Help();
+        errx(1, "number of couples must be positive");
+      }
+      break;
+    case 'c':
+      cutValue = strtod(optarg, NULL)*mm;
+      if (cutValue <= 0) {
+        Help();
+        errx(1, "production cut value must be positive");
+      }
+      break;
+    case 'j':
+      jsonFile = optarg;
+      break;
+    case 'h':
+      Help();
+      return 0;
+    default:
+      Help();
+      errx(1, "unknown option %c", c);
+    }
+  }
+
+  StageTimer timer;
+  //
+  // --- Set up a fake G4 geometry with the required number of material-cuts couples
+  timer.Start();
+  FakeG4SetupWithCouples(numCouples, cutValue, 1);
+  timer.Stop("geometry (G4)");
+  //
+  // --- The stages of the G4HepEm data initialisation: parameters, materials
+  //     and couples, then the e-, e+ and gamma data
+  G4HepEmData* hepEmData = new G4HepEmData;
+  InitG4HepEmData(hepEmData);
+  G4HepEmParameters* hepEmPars = new G4HepEmParameters;
+  timer.Start();
+  InitHepEmParameters(hepEmPars);
+  InitMaterialAndCoupleData(hepEmData, hepEmPars);
+  timer.Stop("materials and couples");
+  StageHookData hookData = {&timer, "e-"};
+  InitElectronData(hepEmData, hepEmPars, true, 0, StageHook, &hookData);
+  hookData.fParticle = "e+";
+  InitElectronData(hepEmData, hepEmPars, false, 0, StageHook, &hookData);
+  hookData.fParticle = "gamma";
+  InitGammaData(hepEmData, hepEmPars, 0, StageHook, &hookData);
+  const int    numHepEmCouples = hepEmData->fTheMatCutData->fNumMatCutData;
+  const double peakRSS         = GetPeakRSSMB();
+  FreeG4HepEmData(hepEmData);
+  delete hepEmData;
+  FreeG4HepEmParameters(hepEmPars);
+  delete hepEmPars;
+  //
+  // --- The complete initialisation by the `G4HepEmRunManager` as a reference
+  G4HepEmRunManager* runMgr = new G4HepEmRunManager(true);
+  G4HepEmRandomEngine* rnge = new G4HepEmRandomEngine(G4Random::getTheEngine());
+  const auto start = std::chrono::steady_clock::now();
+  for (int ip=0; ip<3; ++ip) {
+    runMgr->Initialize(rnge, ip);
+  }
+  const double totalRunMgr = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  delete runMgr;
+  //
+  // --- Report
+  const std::vector<Stage>& stages = timer.GetStages();
+  double totalStages = 0.0;
+  std::cout << "\n === G4HepEm initialisation with " << numHepEmCouples << " material-cuts couples\n"
+            << std::left << std::setw(28) << "   stage" << std::right << std::setw(12) << "time [s]"
+            << std::setw(16) << "d(RSS) [MB]" << std::endl;
+  for (std::size_t is=0; is<stages.size(); ++is) {
+    std::cout << "   " << std::left << std::setw(25) << stages[is].fName << std::right << std::fixed
+              << std::setprecision(4) << std::setw(12) << stages[is].fTime
+              << std::setprecision(2) << std::setw(16) << stages[is].fDRSS << std::endl;
+    // the geometry is not part of the G4HepEm initialisation
+    totalStages += is > 0 ? stages[is].fTime : 0.0;
+  }
+  std::cout << std::setprecision(4)
+            << "   " << std::left << std::setw(25) << "total (stages)" << std::right << std::setw(12) << totalStages << "\n"
+            << "   " << std::left << std::setw(25) << "total (G4HepEmRunManager)" << std::right << std::setw(12) << totalRunMgr << "\n"
+            << std::setprecision(2)
+            << "   " << std::left << std::setw(25) << "peak RSS [MB]" << std::right << std::setw(12) << peakRSS << "\n"
+            << std::endl;
+
+  if (!jsonFile.empty()) {
+    std::ofstream json(jsonFile);
+    json << "{\n  \"num_couples\": " << numHepEmCouples << ",\n  \"cut_value_mm\": " << cutValue/mm
+         << ",\n  \"stages\": [\n";
+    for (std::size_t is=0; is<stages.size(); ++is) {
+      json << "    {\"name\": \"" << stages[is].fName << "\", \"time_s\": " << stages[is].fTime
+           << ", \"delta_rss_mb\": " << stages[is].fDRSS << "}" << (is+1 < stages.size() ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"total_stages_s\": " << totalStages << ",\n  \"total_run_manager_s\": " << totalRunMgr
+         << ",\n  \"peak_rss_mb\": " << peakRSS << "\n}\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,303 @@
+
+// local (and TestUtils) includes
+#include "TestUtils/Hist.hh"
+
+// the observables file of the TestEm3 benchmark mode
+#include "BenchmarkComparison.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <err.h>
+#include <getopt.h>
+
+//
+// Physics regression test: compares the distributions of the per-event
+// observables of a fixed TestEm3 configuration (written by the benchmark mode
+// of TestEm3 with the `-o` option) to the stored reference histograms by
+// chi-square tests. Since many optimisations change the random number
+// consumption, the results cannot be compared event by event, only their
+// distributions. The histograms are:
+//
+//  - the distribution of each per-event observable, i.e. the energy deposit per
+//    absorber, the longitudinal and lateral leakage, the number of tracks and
+//    steps of gamma, e- and e+ (the binning is fixed by the reference),
+//  - the mean energy deposit per layer (i.e. the longitudinal profile).
+//
+// A histogram is not compatible with its reference if the p-value is below
+// `alpha`/(number of histograms). The throughput of the run (events/s and
+// steps/s) is also reported (together with the reference values).
+//
+// The reference is written by the `-w` flag from the observables file (see the
+// `PhysicsRegression_references` target). A missing reference is a failure.
+//
+
+static struct option options[] = {
+    {"input-file   (observables file written by TestEm3)  - REQUIRED",      required_argument, 0, 'i'},
+    {"ref-file     (reference histograms file)            - REQUIRED",      required_argument, 0, 'r'},
+    {"write-ref    (write the reference from the input)   - default: false", no_argument,      0, 'w'},
+    {"alpha        (significance level of the tests)      - default: 0.001", required_argument, 0, 'a'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}};
+
+static void Help() {
+  std::cout<<"\n "<<std::setw(100)<<std::setfill('=')<<""<<std::setfill(' ')<<std::endl;
+  std::cout<<"  PhysicsRegression: compares TestEm3 observables to the reference histograms"<<std::endl;
+  std::cout<<"\n  Usage: PhysicsRegression [OPTIONS] \n"<<std::endl;
+  for (int i = 0; options[i].name != NULL; i++) {
+    printf("\t-%c  --%s\n", options[i].val, options[i].name);
+  }
+  std::cout<<"\n "<<std::setw(100)<<std::setfill('=')<<""<<std::setfill(' ')<<std::endl;
+}
+
+// the number of bins of the per-event observable distributions
+static const int kNumBins = 50;
+// name of the longitudinal profile histogram (made of the per layer columns)
+static const std::string kProfileName = "Edep_per_layer";
+
+// A named histogram of the observables.
+struct NamedHist {
+  std::string fName;
+  Hist*       fHist;
+};
+
+// Throughput of a run: events/s and steps/s (per tracking time).
+struct Throughput {
+  double fEventsPerSec = 0.0;
+  double fStepsPerSec  = 0.0;
+};
+
+static Throughput GetThroughput(const BenchmarkResult& res) {
+  Throughput thr;
+  if (res.fLoopTime > 0.0) {
+    thr.fEventsPerSec = res.fNumEvents / res.fLoopTime;
+  }
+  long   numSteps = 0;
+  double time     = 0.0;
+  for (const BenchmarkResult::Throughput& t : res.fThroughput) {
+    numSteps += t.fNumSteps;
+    time     += t.fTrackingTime;
+  }
+  if (time > 0.0) {
+    thr.fStepsPerSec = numSteps / time;
+  }
+  return thr;
+}
+
+static bool IsLayerColumn(const std::string& name) {
+  return name.compare(0, 10, "Edep_layer") == 0;
+}
+
+// Fills the histogram with the given name from the observables.
+static void FillHist(const BenchmarkResult& res, const std::string& name, Hist* hist) {
+  if (name == kProfileName) {
+    int il = 0;
+    for (std::size_t i = 0; i < res.fNames.size(); ++i) {
+      if (!IsLayerColumn(res.fNames[i])) {
+        continue;
+      }
+      for (double edep : res.fValues[i]) {
+        hist->Fill(il + 0.5, edep);
+      }
+      ++il;
+    }
+    return;
+  }
+  const auto it = std::find(res.fNames.begin(), res.fNames.end(), name);
+  if (it == res.fNames.end()) {
+    errx(1, "observable %s is not in the input file", name.c_str());
+  }
+  for (double val : res.fValues[it - res.fNames.begin()]) {
+    hist->Fill(std::max(0.0, val));
+  }
+}
+
+// Creates the histograms (with the binning fixed by the observed ranges).
+static std::vector<NamedHist> CreateHists(const BenchmarkResult& res) {
+  std::vector<NamedHist> hists;
+  int numLayers = 0;
+  for (std::size_t i = 0; i < res.fNames.size(); ++i) {
+    if (IsLayerColumn(res.fNames[i])) {
+      ++numLayers;
+      continue;
+    }
+    const std::vector<double>& vals = res.fValues[i];
+    const double maxVal = vals.empty() ? 0.0 : *std::max_element(vals.begin(), vals.end());
+    hists.push_back({res.fNames[i], new Hist(0.0, maxVal > 0.0 ? 1.1 * maxVal : 1.0, kNumBins)});
+  }
+  if (numLayers > 0) {
+    hists.push_back({kProfileName, new Hist(0.0, double(numLayers), numLayers)});
+  }
+  for (NamedHist& h : hists) {
+    FillHist(res, h.fName, h.fHist);
+  }
+  return hists;
+}
+
+// The reference: number of events, throughput and the histograms (the sum of
+// the weights and the squared weights per bin).
+static bool WriteReference(const std::string& fileName, const BenchmarkResult& res,
+                           const std::vector<NamedHist>& hists) {
+  std::ofstream out(fileName);
+  if (!out) {
+    return false;
+  }
+  const Throughput thr = GetThroughput(res);
+  out << std::setprecision(12);
+  out << "# G4HepEm physics regression reference\n";
+  out << "# physics " << res.fPhysics << "\n";
+  out << "events " << res.fNumEvents << "\n";
+  out << "throughput " << thr.fEventsPerSec << " " << thr.fStepsPerSec << "\n";
+  for (const NamedHist& h : hists) {
+    out << "hist " << h.fName << " " << h.fHist->GetMin() << " " << h.fHist->GetMax() << " "
+        << h.fHist->GetNumBins() << "\n";
+    for (int ib = 0; ib < h.fHist->GetNumBins(); ++ib) {
+      out << h.fHist->GetY()[ib] << " " << h.fHist->GetY2()[ib] << "\n";
+    }
+  }
+  return true;
+}
+
+static void DeleteHists(std::vector<NamedHist>& hists) {
+  for (NamedHist& h : hists) {
+    delete h.fHist;
+  }
+  hists.clear();
+}
+
+static bool ReadReference(const std::string& fileName, double& numEvents, Throughput& thr,
+                          std::vector<NamedHist>& hists) {
+  std::ifstream in(fileName);
+  if (!in) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream ss(line);
+    std::string key;
+    ss >> key;
+    if (key == "events") {
+      ss >> numEvents;
+    } else if (key == "throughput") {
+      ss >> thr.fEventsPerSec >> thr.fStepsPerSec;
+    } else if (key == "hist") {
+      std::string name;
+      double min, max;
+      int numBins;
+      ss >> name >> min >> max >> numBins;
+      Hist* hist = new Hist(min, max, numBins);
+      for (int ib = 0; ib < numBins && std::getline(in, line); ++ib) {
+        std::istringstream bin(line);
+        bin >> hist->GetY()[ib] >> hist->GetY2()[ib];
+      }
+      hists.push_back({name, hist});
+    }
+  }
+  return numEvents > 0.0 && !hists.empty();
+}
+
+
+int main(int argc, char* argv[]) {
+  std::string inputFile;
+  std::string refFile;
+  bool        isWriteRef = false;
+  double      alpha      = 0.001;
+  while (true) {
+    int c, optidx = 0;
+    c = getopt_long(argc, argv, "i:r:wa:h", options, &optidx);
+    if (c == -1)
+      break;
+    switch (c) {
+    case 0:
+      c = options[optidx].val;
+      /* fall through */
+    case 'i':
+      inputFile = optarg;
+      break;
+    case 'r':
+      refFile = optarg;
+      break;
+    case 'w':
+      isWriteRef = true;
+      break;
+    case 'a':
+      alpha = std::stod(optarg);
+      break;
+    case 'h':
+      Help();
+      return 0;
+    default:
+      Help();
+      errx(1, "unknown option %c", c);
+    }
+  }
+  if (inputFile.empty() || refFile.empty()) {
+    Help();
+    errx(1, "both the input and the reference files are required");
+  }
+
+  BenchmarkResult res;
+  if (!ReadBenchmarkResult(inputFile, res) || res.fNumEvents <= 0) {
+    errx(1, "cannot read the observables from %s", inputFile.c_str());
+  }
+  const Throughput thr = GetThroughput(res);
+
+  if (isWriteRef) {
+    std::vector<NamedHist> hists = CreateHists(res);
+    const bool isWritten = WriteReference(refFile, res, hists);
+    DeleteHists(hists);
+    if (!isWritten) {
+      errx(1, "cannot write the reference file %s", refFile.c_str());
+    }
+    std::cout << " === PhysicsRegression: reference written into " << refFile << std::endl;
+    return 0;
+  }
+
+  double                 refNumEvents = 0.0;
+  Throughput             refThr;
+  std::vector<NamedHist> refHists;
+  if (!ReadReference(refFile, refNumEvents, refThr, refHists)) {
+    DeleteHists(refHists);
+    std::cerr << " *** PhysicsRegression: cannot read the reference file " << refFile << "\n"
+              << "     it can be written by: PhysicsRegression -i " << inputFile << " -r "
+              << refFile << " -w" << std::endl;
+    return 1;
+  }
+
+  // the tests: the histograms are filled with the binning of the reference
+  const double pCut = alpha / refHists.size();
+  std::cout << "\n === PhysicsRegression: " << res.fPhysics << " (" << res.fNumEvents
+            << " events) vs. reference (" << refNumEvents << " events)\n"
+            << "     chi-square tests (not compatible if p < " << pCut << "):\n"
+            << std::setw(20) << "histogram" << std::setw(14) << "chi2" << std::setw(8) << "ndf"
+            << std::setw(14) << "p-value" << std::endl;
+  int numFailed = 0;
+  for (const NamedHist& ref : refHists) {
+    Hist hist(ref.fHist->GetMin(), ref.fHist->GetMax(), ref.fHist->GetNumBins());
+    FillHist(res, ref.fName, &hist);
+    int ndf;
+    const double chi2   = hist.Chi2Test(*ref.fHist, res.fNumEvents, refNumEvents, ndf);
+    const double pValue = Hist::Chi2PValue(chi2, ndf);
+    const bool isFailed = pValue < pCut;
+    numFailed += isFailed ? 1 : 0;
+    std::cout << std::setw(20) << ref.fName << std::setw(14) << chi2 << std::setw(8) << ndf
+              << std::setw(14) << pValue << (isFailed ? "   <== NOT COMPATIBLE" : "") << std::endl;
+  }
+  // the throughput is only reported (it depends on the machine)
+  std::cout << "\n     throughput:  events/s = " << thr.fEventsPerSec << " (reference: "
+            << refThr.fEventsPerSec << "),  steps/s = " << thr.fStepsPerSec << " (reference: "
+            << refThr.fStepsPerSec << ")" << std::endl;
+  std::cout << "\n     " << numFailed << " of the " << refHists.size()
+            << " histograms are not compatible with the reference." << std::endl;
+  DeleteHists(refHists);
+  return numFailed > 0 ? 1 : 0;
+}
@@ -12,6 +12,7 @@
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
 #include "G4Region.hh"
+#include "G4RegionStore.hh"
 
 #include "G4ParticleDefinition.hh"
 #include "G4ParticleTable.hh"
@@ -163,3 +164,70 @@ const G4MaterialCutsCouple* FakeG4Setup ( G4double prodCutInLength, const G4Stri
   // return with a pointer to teh registered material-cuts couple
   return couple0;
 }
+
+
+// builds a fake Geant4 geometry with the required number of material-cuts couples
+void FakeG4SetupWithCouples ( G4int numCouples, G4double prodCutInLength, G4int verbose) {
+  //
+  // --- Geometry definition: create the word
+  G4Material*       wMat = G4NistManager::Instance()->FindOrBuildMaterial("G4_Galactic");
+  G4Box*              sW = new G4Box ("Box", 0.6*m, 0.6*m, 0.6*m);
+  G4LogicalVolume*    lW = new G4LogicalVolume(sW,wMat,"Box",0,0,0);
+  G4PVPlacement*      pW = new G4PVPlacement(0,G4ThreeVector(),"Box",lW,0,false,0);
+  // set the world volume for the GetTransportationManager::G4Navigator
+  G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->SetWorldVolume(pW);
+  //
+  // --- Create particles that has secondary production threshold
+  G4Gamma::Gamma();
+  G4Electron::Electron();
+  G4Positron::Positron();
+  G4Proton::Proton();
+  G4ParticleTable* partTable = G4ParticleTable::GetParticleTable();
+  partTable->SetReadiness();
+  //
+  // --- Create the world region with the given secondary production threshold
+  G4ProductionCuts* pcutW = new G4ProductionCuts();
+  pcutW->SetProductionCut(prodCutInLength);
+  G4Region* regW = new G4Region("DefaultRegionForTheWorld");
+  regW->AddRootLogicalVolume(lW);
+  regW->UsedInMassGeometry(true);
+  regW->SetProductionCuts(pcutW);
+  //
+  // --- Place one box for each of the required couples: the NIST materials are
+  //     used cyclically and each cycle is a separate region (root logical volumes)
+  //     with a different production threshold, i.e. different material-cuts couples
+  const std::vector<G4String>& namesMat = G4NistManager::Instance()->GetNistMaterialNames();
+  const G4int    numMat = namesMat.size();
+  const G4double halfX  = 0.5*m/numCouples;  // half width of one material-box
+  const G4double x0     = -0.5*m+halfX;      // position of the first material-box
+  G4Region* reg = nullptr;
+  for (G4int ic=0; ic<numCouples; ++ic) {
+    const G4int im = ic%numMat;
+    const G4int ir = ic/numMat;
+    if (im == 0) {
+      G4ProductionCuts* pcut = new G4ProductionCuts();
+      pcut->SetProductionCut(prodCutInLength*(1.0+0.01*(ir+1)));
+      reg = new G4Region("FakeRegion_" + std::to_string(ir));
+      reg->UsedInMassGeometry(true);
+      reg->SetProductionCuts(pcut);
+    }
+    G4Material*       mat = G4NistManager::Instance()->FindOrBuildMaterial(namesMat[im]);
+    G4Box*             ss = new G4Box ("Box", halfX, 0.5*m, 0.5*m);
+    G4LogicalVolume*   ll = new G4LogicalVolume(ss, mat, "Box", 0, 0, 0);
+    new G4PVPlacement(0, G4ThreeVector(x0+2*ic*halfX, 0, 0), "Box", ll, pW, false, 0);
+    reg->AddRootLogicalVolume(ll);
+  }
+  //
+  // --- Update the material lists of the regions then the couple tables
+  G4RegionStore::GetInstance()->UpdateMaterialList(pW);
+  G4ProductionCutsTable* theCoupleTable = G4ProductionCutsTable::GetProductionCutsTable();
+  theCoupleTable->UpdateCoupleTable(pW);
+  //
+  if ( verbose>0 ) {
+    G4cout << " === FakeG4SetupWithCouples() completed: \n"
+           << "     - number of G4MaterialCutsCouple objects built = " << theCoupleTable->GetTableSize() << "     \n"
+           << "     - number of regions (without the world)        = " << (numCouples+numMat-1)/numMat << "     \n"
+           << "     - with secondary production threshold          = " << prodCutInLength << " [mm] (world)\n"
+           << G4endl;
+  }
+}
@@ -16,8 +16,9 @@ class G4MaterialCutsCouple;
  * Simple utility functions to construct a fake Geant4 detector geometry.
  *
  * The detector can be constructed either with a single, specific target material
- * or including all pre-defined NIST materials. The secondary production threshold
- * can also be spefified.
+ * or including all pre-defined NIST materials (optionally with many regions in
+ * order to have a given number of material-cuts couples). The secondary production
+ * threshold can also be spefified.
  */
 
 
@@ -28,6 +29,11 @@ void FakeG4Setup ( G4double prodCutInLength,  G4int verbose=1 );
 const G4MaterialCutsCouple*
 FakeG4Setup ( G4double prodCutInLength, const G4String& nistMatName, G4int verbose=1);
 
+// builds a fake Geant4 geometry with the given number of material-cuts couples
+// (plus the world): the G4-NIST materials are used cyclically and each cycle is
+// placed in a separate detector region with a different production threshold
+void FakeG4SetupWithCouples ( G4int numCouples, G4double prodCutInLength, G4int verbose=1 );
+
 
 
 
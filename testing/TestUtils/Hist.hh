@@ -7,6 +7,8 @@
 #include <iostream>
 #include <string>
 #include <cstdio>
+#include <cmath>
+#include <algorithm>
 
 class Hist {
 public:
@@ -18,9 +20,11 @@ public:
     fDelta   = (fMax - fMin) / (numbin);
     fx       = new double[fNumBins];
     fy       = new double[fNumBins];
+    fy2      = new double[fNumBins];
     for (int i = 0; i < fNumBins; ++i) {
-      fx[i] = fMin + i * fDelta;
-      fy[i] = 0.0;
+      fx[i]  = fMin + i * fDelta;
+      fy[i]  = 0.0;
+      fy2[i] = 0.0;
     }
     fSum = 0.0;
   }
@@ -33,13 +37,25 @@ public:
     fNumBins = (int)((fMax - fMin) / (delta)) + 1.0;
     fx       = new double[fNumBins];
     fy       = new double[fNumBins];
+    fy2      = new double[fNumBins];
     for (int i = 0; i < fNumBins; ++i) {
-      fx[i] = fMin + i * fDelta;
-      fy[i] = 0.0;
+      fx[i]  = fMin + i * fDelta;
+      fy[i]  = 0.0;
+      fy2[i] = 0.0;
     }
     fSum = 0.0;
   }
 
+  ~Hist()
+  {
+    delete[] fx;
+    delete[] fy;
+    delete[] fy2;
+  }
+
+  Hist(const Hist&)            = delete;
+  Hist& operator=(const Hist&) = delete;
+
   void Fill(double x)
   {
     int indx = (int)((x - fMin) / fDelta);
@@ -47,8 +63,13 @@ public:
       std::cerr << "\n ***** ERROR in Hist::FILL  =>  x = " << x << " < fMin = " << fMin << std::endl;
       exit(1);
     }
+    // overflow goes into the last bin
+    if (indx >= fNumBins) {
+      indx = fNumBins - 1;
+    }
 
-    fy[indx] += 1.0;
+    fy[indx]  += 1.0;
+    fy2[indx] += 1.0;
   }
 
   void Fill(double x, double w)
@@ -58,8 +79,13 @@ public:
       std::cerr << "\n ***** ERROR in Hist::FILL  =>  x = " << x << " < fMin = " << fMin << std::endl;
       exit(1);
     }
+    // overflow goes into the last bin
+    if (indx >= fNumBins) {
+      indx = fNumBins - 1;
+    }
 
-    fy[indx] += 1.0 * w;
+    fy[indx]  += 1.0 * w;
+    fy2[indx] += w * w;
   }
 
 
@@ -72,14 +98,84 @@ public:
   }
 
 
+  // Chi-square test of the compatibility of this and the `other` histogram,
+  // both filled (at most once per bin) in each of the `numEvents` and
+  // `otherNumEvents` events, i.e. the per-event mean bin contents and their
+  // variances are compared. The number of degrees of freedom (bins with
+  // non-zero variance) is set and the chi-square is returned.
+  double Chi2Test(const Hist& other, double numEvents, double otherNumEvents, int& ndf) const
+  {
+    double chi2 = 0.0;
+    ndf = 0;
+    for (int i = 0; i < fNumBins && i < other.fNumBins; ++i) {
+      const double mean1 = fy[i] / numEvents;
+      const double mean2 = other.fy[i] / otherNumEvents;
+      const double var1  = std::max(0.0, fy2[i] / numEvents - mean1 * mean1) / numEvents;
+      const double var2  = std::max(0.0, other.fy2[i] / otherNumEvents - mean2 * mean2) / otherNumEvents;
+      if (var1 + var2 > 0.0) {
+        chi2 += (mean1 - mean2) * (mean1 - mean2) / (var1 + var2);
+        ++ndf;
+      }
+    }
+    return chi2;
+  }
+
+  // The p-value of the chi-square with `ndf` degrees of freedom, i.e. the
+  // regularized upper incomplete gamma function Q(ndf/2, chi2/2).
+  static double Chi2PValue(double chi2, int ndf)
+  {
+    if (ndf <= 0 || chi2 <= 0.0) {
+      return 1.0;
+    }
+    const double a = 0.5 * ndf;
+    const double x = 0.5 * chi2;
+    const double lnPre = a * std::log(x) - x - std::lgamma(a);
+    if (x < a + 1.0) {
+      // series of P(a,x)
+      double term = 1.0 / a;
+      double sum  = term;
+      for (int n = 1; n < 1000 && std::abs(term) > 1.0E-14 * std::abs(sum); ++n) {
+        term *= x / (a + n);
+        sum  += term;
+      }
+      return std::max(0.0, 1.0 - sum * std::exp(lnPre));
+    }
+    // continued fraction of Q(a,x) (modified Lentz)
+    const double tiny = 1.0E-300;
+    double b = x + 1.0 - a;
+    double c = 1.0 / tiny;
+    double d = 1.0 / b;
+    double h = d;
+    for (int n = 1; n < 1000; ++n) {
+      const double an = -n * (n - a);
+      b += 2.0;
+      d  = an * d + b;
+      d  = std::abs(d) < tiny ? tiny : d;
+      c  = b + an / c;
+      c  = std::abs(c) < tiny ? tiny : c;
+      d  = 1.0 / d;
+      const double del = d * c;
+      h *= del;
+      if (std::abs(del - 1.0) < 1.0E-14) {
+        break;
+      }
+    }
+    return std::exp(lnPre) * h;
+  }
+
   int GetNumBins() const { return fNumBins; }
+  double GetMin() const { return fMin; }
+  double GetMax() const { return fMax; }
   double GetDelta() const { return fDelta; }
   double *GetX() const { return fx; }
   double *GetY() const { return fy; }
+  // sum of the squared weights per bin
+  double *GetY2() const { return fy2; }
 
 private:
   double *fx;
   double *fy;
+  double *fy2;
   double fMin;
   double fMax;
   double fDelta;
@@ -0,0 +1,64 @@
+
+// G4HepEm includes
+#include "G4HepEmWeightWindow.hh"
+
+#include <cmath>
+#include <iostream>
+
+
+// Mean weight after the roulette over `num` stratified random numbers on [0,1).
+static double MeanWeightAfterRoulette(double weight, double survival, int num) {
+  double sum = 0.0;
+  for (int i=0; i<num; ++i) {
+    sum += G4HepEmWeightWindow::PlayRoulette(weight, survival, (i+0.5)/num);
+  }
+  return sum/num;
+}
+
+
+int main() {
+  bool isOK = true;
+  // 1. Russian roulette: the expected weight is kept for any weight below the
+  //    lower bound when the survival weight is not below it.
+  {
+    const int    kNumRand = 1000000;
+    // lower bound 0.5: survival weights not below and weights below that
+    const double survivals[] = {0.5, 0.75, 1.0, 3.0};
+    const double weights[]   = {1.0E-3, 0.01, 0.1, 0.25, 0.4, 0.499};
+    for (double survival : survivals) {
+      // each stratum can change the mean weight by `survival/kNumRand` at most
+      const double tolerance = 2.0*survival/kNumRand;
+      for (double weight : weights) {
+        const double mean = MeanWeightAfterRoulette(weight, survival, kNumRand);
+        if (std::abs(mean - weight) > tolerance) {
+          std::cerr << " *** Russian roulette: mean weight = " << mean << " while expected " << weight
+                    << " (survival weight = " << survival << ")" << std::endl;
+          isOK = false;
+        }
+      }
+    }
+  }
+  // 2. Splitting: the weights of the split tracks sum up to the original one
+  //    and all are within the window (unless the maximum number is reached).
+  {
+    const int    kMaxNumSplit = 100;
+    const double upper        = 2.0;
+    const double weights[]    = {2.000001, 2.5, 4.0, 10.0, 199.9, 1000.0};
+    for (double weight : weights) {
+      const int    numSplit  = G4HepEmWeightWindow::GetNumSplit(weight, upper, kMaxNumSplit);
+      const double newWeight = weight/numSplit;
+      if (numSplit < 2 || numSplit > kMaxNumSplit || std::abs(numSplit*newWeight - weight) > 1.0E-12*weight ||
+          (numSplit < kMaxNumSplit && newWeight > upper)) {
+        std::cerr << " *** Splitting: weight = " << weight << " is split into " << numSplit
+                  << " tracks with weight = " << newWeight << " (upper bound = " << upper << ")" << std::endl;
+        isOK = false;
+      }
+    }
+  }
+
+  if (!isOK) {
+    std::cerr << " *** TestWeightWindow: FAILED" << std::endl;
+    return 1;
+  }
+  return 0;
+}